@@ -0,0 +1,952 @@
+#include "CompressorEngine.h"
+#include "EnvelopeScan.h"
+#include "ScopedFlushDenormals.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+static_assert(CompressorEngine::maxChannels <= SidechainFilterBank::maxChannels,
+              "The sidechain filter bank needs a lane per channel");
+
+namespace
+{
+    float decibelsToGain(float decibels)
+    {
+        return decibels > -100.0f ? std::pow(10.0f, decibels * 0.05f) : 0.0f;
+    }
+
+    float gainToDecibels(float gain)
+    {
+        return gain > 0.0f ? std::max(-100.0f, std::log10(gain) * 20.0f) : -100.0f;
+    }
+}
+
+//==============================================================================
+void CompressorEngine::LinearSmoothedValue::reset(double sr, double rampSeconds)
+{
+    stepsToTarget = static_cast<int>(std::floor(rampSeconds * sr));
+    setCurrentAndTargetValue(target);
+}
+
+void CompressorEngine::LinearSmoothedValue::setCurrentAndTargetValue(float value)
+{
+    target = current = value;
+    countdown = 0;
+}
+
+void CompressorEngine::LinearSmoothedValue::setTargetValue(float value)
+{
+    if (value == target)
+        return;
+
+    if (stepsToTarget <= 0)
+    {
+        setCurrentAndTargetValue(value);
+        return;
+    }
+
+    target = value;
+    countdown = stepsToTarget;
+    step = (target - current) / static_cast<float>(countdown);
+}
+
+float CompressorEngine::LinearSmoothedValue::getNextValue()
+{
+    if (countdown <= 0)
+        return target;
+
+    --countdown;
+    current = countdown > 0 ? current + step : target;
+    return current;
+}
+
+//==============================================================================
+CompressorEngine::CompressorEngine()
+{
+    mixcomp_default_params(&params);
+    makeupGainSmoothed.reset(44100.0, makeupRampSeconds); // 50ms smoothing
+}
+
+CompressorEngine::~CompressorEngine()
+{
+    if (resources != &inlineResources)
+        delete resources;
+
+    delete pendingResources.exchange(nullptr);
+    delete retiredResources.exchange(nullptr);
+}
+
+void CompressorEngine::prepare(double newSampleRate, int numChannels)
+{
+    sampleRate = newSampleRate;
+    numPreparedChannels = std::clamp(numChannels, 1, maxChannels);
+
+    // Pick the kernel variant for this machine once, off the hot path
+    kernels = &DSPKernels::getKernels(kernelVariantOverride >= 0 ? static_cast<DSPKernels::Variant>(kernelVariantOverride)
+                                                                : DSPKernels::getPreferredVariant());
+
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        stage1[ch].prepare(sampleRate, *kernels);
+        stage2[ch].prepare(sampleRate, *kernels);
+    }
+
+    makeupGainSmoothed.reset(sampleRate, makeupRampSeconds);
+    governor.prepare(sampleRate);
+    outputLimiter.prepare(sampleRate);
+
+    // Side-chain detector EQ snaps to the first design instead of gliding
+    sidechainFilters.prepare();
+
+    // First resource set, built here so process() never starts without one. Sets published
+    // for another sample rate are stale now.
+    if (resources != &inlineResources)
+        delete resources;
+
+    delete pendingResources.exchange(nullptr);
+    inlineResources.build(EngineResources::Key::fromParameters(params, sampleRate));
+    resources = &inlineResources;
+
+    rmsCoef = 1.0f - std::exp(-1.0f / (rmsTimeConstantSeconds * static_cast<float>(sampleRate)));
+    grMeterReleaseCoef = std::exp(-1.0f / (grMeterReleaseSeconds * static_cast<float>(sampleRate)));
+
+    // History bins are whole sub-blocks of roughly 10ms
+    historySubBlocksPerBin = std::max(1, static_cast<int>(std::lround(sampleRate * historyBinTargetSeconds / subBlockSize)));
+    historyBinSeconds.store(historySubBlocksPerBin * subBlockSize / sampleRate);
+
+    reset();
+}
+
+void CompressorEngine::reset()
+{
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        stage1[ch].reset();
+        stage2[ch].reset();
+        dcBlockerX1[ch] = 0.0f;
+        dcBlockerY1[ch] = 0.0f;
+    }
+
+    sidechainFilters.reset();
+    truePeakDetector.reset();
+    outputLimiter.reset();
+    makeupGainSmoothed.setCurrentAndTargetValue(1.0f);
+
+    inputMeanSquare = 0.0f;
+    outputMeanSquare = 0.0f;
+    grMeterEnvelope = 0.0f;
+    subBlockMaxGR = 0.0f;
+    currentGainReduction.store(0.0f);
+    inputRMS.store(0.0f);
+    outputRMS.store(0.0f);
+
+    historySubBlocksRemaining = historySubBlocksPerBin;
+    resetHistoryBin();
+
+    governor.reset();
+    clipCount = 0;
+    callbackCount = 0;
+    callbackMeanMicros = 0.0f;
+    callbackMaxMicros = 0.0f;
+    requestedTier = activeTier = fadeFromTier = QualityGovernor::Full;
+    tierFadeRemaining = 0;
+    qualityTier.store(QualityGovernor::Full);
+    cpuLoad.store(0.0f);
+
+    // Force a parameter refresh on the first sample
+    samplesUntilParameterUpdate = 0;
+}
+
+void CompressorEngine::process(float* const* channels, int numChannels, int numSamples)
+{
+    ScopedFlushDenormals noDenormals;
+    MIXCOMP_TRACE_SCOPE("process", numSamples);
+
+    numChannels = std::min(numChannels, numPreparedChannels);
+
+    // Adaptive quality and telemetry time the whole call against its real-time deadline
+    const bool measureLoad = adaptiveQuality || telemetry.isAttached();
+    const auto callStart = measureLoad ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+    // One clock read per call stamps every level this call publishes to the link group
+    if (detectorLink.isJoined())
+        linkTimestamp = DetectorLink::now();
+
+    // Walk the buffer in sub-blocks aligned to a fixed grid, so parameter updates happen
+    // every subBlockSize samples regardless of how the caller slices the stream
+    int position = 0;
+    while (position < numSamples)
+    {
+        if (samplesUntilParameterUpdate == 0)
+        {
+            updateParameters();
+            samplesUntilParameterUpdate = subBlockSize;
+        }
+
+        const int numThisTime = std::min(numSamples - position, samplesUntilParameterUpdate);
+        processSubBlock(channels, position, numThisTime, numChannels);
+
+        position += numThisTime;
+        samplesUntilParameterUpdate -= numThisTime;
+
+        // The makeup target only moves once a whole grid sub-block has been seen, so it
+        // steps at the same sample positions whatever the caller's buffer size
+        if (samplesUntilParameterUpdate == 0)
+        {
+            updateMakeupTarget();
+
+            if (--historySubBlocksRemaining == 0)
+            {
+                pushHistoryBin();
+                historySubBlocksRemaining = historySubBlocksPerBin;
+            }
+        }
+    }
+
+    // Update RMS for level-matched comparison
+    inputRMS.store(std::sqrt(inputMeanSquare), std::memory_order_relaxed);
+    outputRMS.store(std::sqrt(outputMeanSquare), std::memory_order_relaxed);
+
+    // Update gain reduction meter
+    currentGainReduction.store(grMeterEnvelope, std::memory_order_relaxed);
+
+    if (measureLoad)
+    {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - callStart;
+
+        if (adaptiveQuality)
+        {
+            requestedTier = governor.update(elapsed.count(), numSamples, cpuBudgetFraction);
+            cpuLoad.store(governor.getLoad(), std::memory_order_relaxed);
+        }
+
+        if (telemetry.isAttached())
+            publishTelemetry(elapsed.count(), numSamples);
+    }
+}
+
+void CompressorEngine::processOffline(float* const* channels, int numChannels, int numSamples, int numThreads)
+{
+    numChannels = std::min(numChannels, numPreparedChannels);
+
+    // A grid sub-block already begun may still run on the previous parameters
+    const int leadIn = std::min(numSamples, samplesUntilParameterUpdate);
+    if (leadIn > 0)
+        process(channels, numChannels, leadIn);
+
+    if (leadIn == numSamples)
+        return;
+
+    float* remaining[maxChannels] = {};
+    for (int channel = 0; channel < numChannels; ++channel)
+        remaining[channel] = channels[channel] + leadIn;
+
+    // Take the snapshot the whole call runs on here; process() carries on from it
+    {
+        ScopedFlushDenormals noDenormals;
+        updateParameters();
+        samplesUntilParameterUpdate = subBlockSize;
+    }
+
+    // The pre-pass needs settings that cannot move between the call's sub-blocks
+    const bool linked = linkMode != MIXCOMP_LINK_OFF && detectorLink.isJoined();
+    const bool steady = !linked && gainCurvePlayer == nullptr && !adaptiveQuality && !backgroundPreparation
+                     && activeTier == QualityGovernor::Full && tierFadeRemaining == 0;
+
+    // and only pays off with an audio-rate detector to scan on two threads or more; otherwise
+    // buffering the side-chain ahead is pure overhead and the call just streams
+    const int scanThreads = EnvelopeScan::getUsefulThreads(numSamples - leadIn, numThreads);
+    const bool scanning = steady && scanThreads >= 2
+                       && (stage1[0].canPrecomputeEnvelope() || (dualStage && stage2[0].canPrecomputeEnvelope()));
+
+    if (scanning)
+        precomputeOffline(remaining, numChannels, numSamples - leadIn, scanThreads);
+
+    offlinePass = scanning;
+    process(remaining, numChannels, numSamples - leadIn);
+    offlinePass = false;
+}
+
+void CompressorEngine::precomputeOffline(float* const* channels, int numChannels, int numSamples, int numThreads)
+{
+    ScopedFlushDenormals noDenormals;
+    MIXCOMP_TRACE_SCOPE("offline.precompute", numSamples);
+
+    // Side-chains first, then an envelope per channel and stage
+    const int numStages = dualStage ? 2 : 1;
+    const auto length = static_cast<size_t>(numSamples);
+    const size_t needed = static_cast<size_t>(numChannels * (1 + numStages)) * length;
+
+    if (needed > offlineBufferSize)
+    {
+        offlineBuffer.reset(new float[needed]);
+        offlineBufferSize = needed;
+    }
+
+    float* sidechains = offlineBuffer.get();
+    float* envelopes = sidechains + static_cast<size_t>(numChannels) * length;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        offlineSidechainData[channel] = sidechains + static_cast<size_t>(channel) * length;
+
+    // Side-chain EQ and true-peak detection over the same sub-blocks process() would run
+    const float* scInputs[maxChannels] = {};
+    float* scOutputs[maxChannels] = {};
+
+    for (int position = 0; position < numSamples; position += subBlockSize)
+    {
+        const int numThisTime = std::min(subBlockSize, numSamples - position);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            scInputs[channel] = channels[channel] + position;
+            scOutputs[channel] = sidechains + static_cast<size_t>(channel) * length + static_cast<size_t>(position);
+        }
+
+        sidechainFilters.process(scInputs, scOutputs, numChannels, numThisTime);
+
+        if (truePeakDetect)
+            truePeakDetector.process(scOutputs, numChannels, numThisTime);
+    }
+
+    // Envelopes of the audio-rate stages; a channel whose side-chain and detector state match
+    // an earlier channel's shares its envelope
+    for (int stageIndex = 0; stageIndex < numStages; ++stageIndex)
+    {
+        const CompressorStage* stages = stageIndex == 0 ? stage1 : stage2;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float*& envelope = offlineEnvelopeData[stageIndex][channel];
+            envelope = nullptr;
+
+            if (!stages[channel].canPrecomputeEnvelope())
+                continue;
+
+            for (int other = 0; other < channel && envelope == nullptr; ++other)
+                if (offlineEnvelopeData[stageIndex][other] != nullptr && stages[other].hasSameStateAs(stages[channel])
+                    && std::memcmp(offlineSidechainData[other], offlineSidechainData[channel], length * sizeof(float)) == 0)
+                    envelope = offlineEnvelopeData[stageIndex][other];
+
+            if (envelope == nullptr)
+            {
+                float* destination = envelopes + static_cast<size_t>(stageIndex * numChannels + channel) * length;
+                stages[channel].precomputeEnvelope(offlineSidechainData[channel], destination, numSamples, numThreads);
+                envelope = destination;
+            }
+        }
+    }
+}
+
+const float* CompressorEngine::getOfflineEnvelope(int stageIndex, int channel, int startSample) const
+{
+    const float* envelope = offlineEnvelopeData[stageIndex][channel];
+    return offlinePass && envelope != nullptr ? envelope + startSample : nullptr;
+}
+
+void CompressorEngine::publishTelemetry(double elapsedSeconds, int numSamples)
+{
+    const float micros = static_cast<float>(elapsedSeconds * 1.0e6);
+    callbackMeanMicros = callbackCount == 0 ? micros : callbackMeanMicros + (micros - callbackMeanMicros) * callbackTimeSmoothing;
+    callbackMaxMicros = std::max(callbackMaxMicros, micros);
+    ++callbackCount;
+
+    Telemetry::Record record;
+    record.gainReductionDB = grMeterEnvelope;
+    record.inputRMS = std::sqrt(inputMeanSquare);
+    record.outputRMS = std::sqrt(outputMeanSquare);
+    record.sampleRate = static_cast<float>(sampleRate);
+    record.clipCount = clipCount;
+    record.callbackCount = callbackCount;
+    record.callbackMeanMicros = callbackMeanMicros;
+    record.callbackMaxMicros = callbackMaxMicros;
+    record.load = numSamples > 0 ? callbackMeanMicros * 1.0e-6f * static_cast<float>(sampleRate) / static_cast<float>(numSamples) : 0.0f;
+    record.blockSize = numSamples;
+    record.qualityTier = activeTier;
+    record.timestampNanos = Telemetry::now();
+    telemetry.publish(record);
+}
+
+void CompressorEngine::updateResources()
+{
+    if (!backgroundPreparation)
+    {
+        // Inline: rebuild at the parameter boundary, so renders are deterministic
+        const auto key = EngineResources::Key::fromParameters(params, sampleRate);
+        if (key != inlineResources.key)
+            inlineResources.build(key);
+
+        return;
+    }
+
+    // Take a published set only once the worker has collected the last one we retired,
+    // so the retired slot never holds more than one set
+    if (retiredResources.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    if (auto* fresh = pendingResources.exchange(nullptr, std::memory_order_acq_rel))
+    {
+        if (fresh->key.sampleRate != sampleRate)
+        {
+            retiredResources.store(fresh, std::memory_order_release);
+            return;
+        }
+
+        if (resources != &inlineResources)
+            retiredResources.store(const_cast<EngineResources*>(resources), std::memory_order_release);
+
+        resources = fresh;
+    }
+}
+
+void CompressorEngine::updateParameters()
+{
+    MIXCOMP_TRACE_SCOPE("parameters", params.topology);
+    updateResources();
+
+    topology = static_cast<DSPKernels::Shaper>(std::clamp(params.topology, 0, 2));
+    dualStage = params.dual_stage != 0;
+    makeupDB = params.makeup_db;
+    autoMakeup = params.auto_makeup != 0;
+    wetMix = params.mix_percent / 100.0f;
+    linkMode = std::clamp(params.link_mode, 0, 2);
+
+    // Side-chain detector EQ (the bank only retargets sections that moved, then glides to them)
+    sidechainFilters.setDesign(resources->sidechain);
+
+    // Inter-sample peak detection restarts from silence when switched on
+    if (params.true_peak_detect != 0 && !truePeakDetect)
+        truePeakDetector.reset();
+
+    truePeakDetect = params.true_peak_detect != 0;
+
+    // Output limiter: engaging it starts from an empty delay line
+    if (params.output_limiter != 0 && !limiterEnabled)
+        outputLimiter.reset();
+
+    limiterEnabled = params.output_limiter != 0;
+    outputLimiter.setParameters(params.limiter_ceiling_db, params.limiter_release_ms);
+
+    // Quality tier: changes wait for any running crossfade to finish
+    adaptiveQuality = params.adaptive_quality != 0 && gainCurveRecorder == nullptr && gainCurvePlayer == nullptr;
+    cpuBudgetFraction = std::clamp(params.cpu_budget_percent, 1.0f, 100.0f) * 0.01f;
+
+    if (!adaptiveQuality && requestedTier != QualityGovernor::Full)
+    {
+        governor.reset();
+        requestedTier = QualityGovernor::Full;
+        cpuLoad.store(0.0f, std::memory_order_relaxed);
+    }
+
+    if (requestedTier != activeTier && tierFadeRemaining == 0)
+        beginTierChange(requestedTier);
+
+    configureStages(stage1, stage2, activeTier);
+
+    if (tierFadeRemaining > 0)
+        configureStages(fadeStage1, fadeStage2, fadeFromTier);
+}
+
+void CompressorEngine::configureStages(CompressorStage* firstStages, CompressorStage* secondStages, int tier)
+{
+    // Pick the detector rate per stage before deriving its coefficients
+    const bool autoDetectorRate = params.detector_rate == MIXCOMP_DETECTOR_AUTO;
+    int controlRate1 = autoDetectorRate ? CompressorStage::chooseControlRate(params.attack1_ms, params.release1_ms, sampleRate) : 1;
+    int controlRate2 = autoDetectorRate ? CompressorStage::chooseControlRate(params.attack2_ms, params.release2_ms, sampleRate) : 1;
+
+    if (tier >= QualityGovernor::ControlRate)
+    {
+        controlRate1 = std::max(controlRate1, QualityGovernor::controlRateFloor);
+        controlRate2 = std::max(controlRate2, QualityGovernor::controlRateFloor);
+    }
+
+    // Stages fall back to the exact curve until the worker has built tables for the current curve
+    const bool useTables = tier >= QualityGovernor::LookupCurve && resources->key.curveTables;
+    const auto* table1 = useTables ? &resources->curveTable1 : nullptr;
+    const auto* table2 = useTables ? &resources->curveTable2 : nullptr;
+
+    const auto curve1 = EngineResources::stageCurve(params, 0);
+    const auto curve2 = EngineResources::stageCurve(params, 1);
+
+    // Set compressor parameters
+    for (int ch = 0; ch < numPreparedChannels; ++ch)
+    {
+        firstStages[ch].setControlRate(controlRate1);
+        secondStages[ch].setControlRate(controlRate2);
+        firstStages[ch].setParameters(curve1, params.attack1_ms, params.release1_ms);
+        secondStages[ch].setParameters(curve2, params.attack2_ms, params.release2_ms);
+        firstStages[ch].setGainCurveTable(table1);
+        secondStages[ch].setGainCurveTable(table2);
+        firstStages[ch].setHighPrecision(params.double_precision != 0);
+        secondStages[ch].setHighPrecision(params.double_precision != 0);
+    }
+}
+
+void CompressorEngine::beginTierChange(int newTier)
+{
+    MIXCOMP_TRACE_SCOPE("tierChange", newTier);
+
+    // The clones keep running the old tier from the same state and are faded out
+    for (int ch = 0; ch < numPreparedChannels; ++ch)
+    {
+        fadeStage1[ch] = stage1[ch];
+        fadeStage2[ch] = stage2[ch];
+    }
+
+    fadeFromTier = activeTier;
+    activeTier = newTier;
+    tierFadeRemaining = tierFadeSamples;
+    qualityTier.store(activeTier, std::memory_order_relaxed);
+}
+
+void CompressorEngine::updateMakeupTarget()
+{
+    makeupGainSmoothed.setTargetValue(getMakeupTarget(makeupDB, autoMakeup, subBlockMaxGR));
+    subBlockMaxGR = 0.0f;
+}
+
+float CompressorEngine::getMakeupTarget(float makeupDB, bool autoMakeup, float maxGainReductionDB)
+{
+    // Calculate and smooth makeup gain (with 3dB headroom)
+    float targetMakeupGain = decibelsToGain(makeupDB);
+
+    if (autoMakeup && maxGainReductionDB > 0.01f)
+    {
+        float autoMakeupDB = calculateAutoMakeup(maxGainReductionDB);
+        targetMakeupGain = decibelsToGain(autoMakeupDB);
+    }
+
+    return targetMakeupGain;
+}
+
+void CompressorEngine::processSubBlock(float* const* channels, int startSample, int numSamples, int numChannels)
+{
+    assert(numSamples <= subBlockSize);
+
+    const float channelWeight = 1.0f / static_cast<float>(std::max(1, numChannels));
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        inputSqScratch[i] = 0.0f;
+        outputSqScratch[i] = 0.0f;
+        totalGRScratch[i] = 0.0f;
+    }
+
+    // Replay: recorded gains stand in for the side-chain and detectors
+    const bool replaying = gainCurvePlayer != nullptr;
+    const int frameSize = getGainCurveFrameSize(numChannels, dualStage);
+
+    if (replaying)
+    {
+        if (gainCurvePlayer(gainCurvePlayerContext, gainCurveFrames, numSamples) == 0)
+        {
+            std::fill(gainCurveFrames, gainCurveFrames + numSamples * frameSize, 1.0f);
+            for (int i = 0; i < numSamples; ++i)
+                gainCurveFrames[i * frameSize] = 0.0f;
+        }
+    }
+    else if (offlinePass)
+    {
+        // Side-chain already run by processOffline
+        for (int channel = 0; channel < numChannels; ++channel)
+            std::copy(offlineSidechainData[channel] + startSample, offlineSidechainData[channel] + startSample + numSamples,
+                      scScratch[channel]);
+    }
+    else
+    {
+        // Detector EQ for all channels in one interleaved pass
+        const float* scInputs[maxChannels] = {};
+        float* scOutputs[maxChannels] = {};
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            scInputs[channel] = channels[channel] + startSample;
+            scOutputs[channel] = scScratch[channel];
+        }
+        {
+            MIXCOMP_TRACE_SCOPE("sidechain", numSamples);
+            sidechainFilters.process(scInputs, scOutputs, numChannels, numSamples);
+
+            if (truePeakDetect)
+                truePeakDetector.process(scOutputs, numChannels, numSamples);
+        }
+
+        if (linkMode != MIXCOMP_LINK_OFF && detectorLink.isJoined())
+            applyDetectorLink(numSamples, numChannels);
+    }
+
+    // Quality tier crossfade: weight of the new tier per sample
+    const bool fading = tierFadeRemaining > 0;
+    if (fading)
+    {
+        const int done = tierFadeSamples - tierFadeRemaining;
+        for (int i = 0; i < numSamples; ++i)
+            fadeWeightScratch[i] = std::min(1.0f, static_cast<float>(done + i + 1) / static_cast<float>(tierFadeSamples));
+    }
+
+    // Dual mono: identical inputs, detector signals and channel state make every channel
+    // compute the same samples, so channel 0 runs alone and the others copy its result
+    const bool mono = !replaying && canProcessAsMono(channels, startSample, numSamples, numChannels, fading);
+    const int numProcessedChannels = mono ? 1 : numChannels;
+
+    for (int channel = 0; channel < numProcessedChannels; ++channel)
+    {
+        auto* channelData = channels[channel] + startSample;
+        auto* dryData = dryScratch[channel];
+        auto* scData = scScratch[channel];
+
+        // Keep the dry signal for parallel mix and DC-block the input
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dryData[i] = channelData[i];
+            historyInputPeak = std::max(historyInputPeak, std::fabs(channelData[i]));
+        }
+
+        kernels->dcBlock(channelData, inputSqScratch, numSamples, dcBlockerX1[channel], dcBlockerY1[channel], dcBlockerA1, channelWeight);
+
+        if (replaying)
+        {
+            replayStage(channelData, channel, 0, numSamples, numChannels);
+
+            if (dualStage)
+                replayStage(channelData, channel, 1, numSamples, numChannels);
+
+            continue;
+        }
+
+        // Outgoing tier, on a copy of the same input
+        if (fading)
+        {
+            std::copy(channelData, channelData + numSamples, fadeScratch);
+            fadeStage1[channel].processBlock(fadeScratch, scData, fadeGRScratch, numSamples, topology);
+
+            if (dualStage)
+                fadeStage2[channel].processBlock(fadeScratch, scData, fadeGRScratch, numSamples, topology);
+        }
+
+        // Stage 1: Leveler (with sidechain)
+        stage1[channel].processBlock(channelData, scData, gr1Scratch, numSamples, topology, getOfflineEnvelope(0, channel, startSample));
+
+        // Stage 2: Peak Catcher (if enabled)
+        if (dualStage)
+            stage2[channel].processBlock(channelData, scData, gr2Scratch, numSamples, topology, getOfflineEnvelope(1, channel, startSample));
+
+        if (gainCurveRecorder != nullptr)
+        {
+            captureStage(stage1[channel], channel, 0, numSamples, numChannels);
+
+            if (dualStage)
+                captureStage(stage2[channel], channel, 1, numSamples, numChannels);
+        }
+
+        if (fading)
+            for (int i = 0; i < numSamples; ++i)
+                channelData[i] = fadeScratch[i] + (channelData[i] - fadeScratch[i]) * fadeWeightScratch[i];
+
+        // Loudest channel drives makeup and metering
+        for (int i = 0; i < numSamples; ++i)
+            totalGRScratch[i] = std::max(totalGRScratch[i], gr1Scratch[i] + (dualStage ? gr2Scratch[i] : 0.0f));
+    }
+
+    if (mono)
+    {
+        // Leave the skipped channels exactly as processing them would have; their squares
+        // accumulate in channel order like the full path
+        for (int channel = 1; channel < numChannels; ++channel)
+        {
+            dcBlockerX1[channel] = dcBlockerX1[0];
+            dcBlockerY1[channel] = dcBlockerY1[0];
+            stage1[channel] = stage1[0];
+
+            if (dualStage)
+                stage2[channel] = stage2[0];
+
+            if (fading)
+            {
+                fadeStage1[channel] = fadeStage1[0];
+
+                if (dualStage)
+                    fadeStage2[channel] = fadeStage2[0];
+            }
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float channelSquare = inputSqScratch[i];
+            for (int channel = 1; channel < numChannels; ++channel)
+                inputSqScratch[i] += channelSquare;
+        }
+    }
+
+    if (fading)
+        tierFadeRemaining = std::max(0, tierFadeRemaining - numSamples);
+
+    if (replaying)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            totalGRScratch[i] = gainCurveFrames[i * frameSize];
+    }
+    else if (gainCurveRecorder != nullptr)
+    {
+        // Dual mono ran channel 0 alone; its gains stand for every channel
+        for (int channel = numProcessedChannels; channel < numChannels; ++channel)
+        {
+            captureStage(stage1[0], channel, 0, numSamples, numChannels);
+
+            if (dualStage)
+                captureStage(stage2[0], channel, 1, numSamples, numChannels);
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+            gainCurveFrames[i * frameSize] = totalGRScratch[i];
+    }
+
+    if (gainCurveRecorder != nullptr)
+        gainCurveRecorder(gainCurveRecorderContext, gainCurveFrames, numSamples);
+
+    // Per-sample GR meter ballistics
+    for (int i = 0; i < numSamples; ++i)
+    {
+        subBlockMaxGR = std::max(subBlockMaxGR, totalGRScratch[i]);
+        historyGRMin = std::min(historyGRMin, totalGRScratch[i]);
+        historyGRMax = std::max(historyGRMax, totalGRScratch[i]);
+        grMeterEnvelope = std::max(totalGRScratch[i], grMeterEnvelope * grMeterReleaseCoef);
+    }
+
+    // One smoothed makeup ramp shared by every channel
+    for (int i = 0; i < numSamples; ++i)
+        makeupScratch[i] = makeupGainSmoothed.getNextValue();
+
+    // Apply mix (parallel compression) and soft clip or limiter
+    MIXCOMP_TRACE_SCOPE("output", numSamples);
+
+    if (limiterEnabled)
+        mixAndLimit(channels, startSample, numSamples, numChannels, numProcessedChannels, channelWeight);
+    else
+        mixAndSoftClip(channels, startSample, numSamples, numChannels, numProcessedChannels, channelWeight);
+
+    // Integrate RMS meters sample by sample
+    inputMeanSquare = kernels->integrateMeanSquare(inputSqScratch, numSamples, inputMeanSquare, rmsCoef);
+    outputMeanSquare = kernels->integrateMeanSquare(outputSqScratch, numSamples, outputMeanSquare, rmsCoef);
+}
+
+void CompressorEngine::mixAndSoftClip(float* const* channels, int startSample, int numSamples, int numChannels,
+                                      int numProcessedChannels, float channelWeight)
+{
+    const bool mono = numProcessedChannels < numChannels;
+
+    for (int channel = 0; channel < numProcessedChannels; ++channel)
+    {
+        auto peak = kernels->mixAndClip(channels[channel] + startSample, dryScratch[channel],
+                                        makeupScratch, outputSqScratch, numSamples, wetMix, channelWeight);
+        historyOutputPeak = std::max(historyOutputPeak, peak);
+
+        if (peak >= 1.0f)
+            clipCount += static_cast<std::uint64_t>(numChannels - numProcessedChannels + 1);
+    }
+
+    if (mono)
+    {
+        for (int channel = 1; channel < numChannels; ++channel)
+            std::copy(channels[0] + startSample, channels[0] + startSample + numSamples, channels[channel] + startSample);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float channelSquare = outputSqScratch[i];
+            for (int channel = 1; channel < numChannels; ++channel)
+                outputSqScratch[i] += channelSquare;
+        }
+    }
+}
+
+void CompressorEngine::mixAndLimit(float* const* channels, int startSample, int numSamples, int numChannels,
+                                   int numProcessedChannels, float channelWeight)
+{
+    float* outputs[maxChannels] = {};
+    for (int channel = 0; channel < numChannels; ++channel)
+        outputs[channel] = channels[channel] + startSample;
+
+    for (int channel = 0; channel < numProcessedChannels; ++channel)
+        kernels->mix(outputs[channel], dryScratch[channel], makeupScratch, numSamples, wetMix);
+
+    for (int channel = numProcessedChannels; channel < numChannels; ++channel)
+        std::copy(outputs[0], outputs[0] + numSamples, outputs[channel]);
+
+    outputLimiter.process(outputs, numChannels, numSamples);
+
+    // Meters see the limited (delayed) output
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float peak = 0.0f;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float out = outputs[channel][i];
+            outputSqScratch[i] += out * out * channelWeight;
+            peak = std::max(peak, std::fabs(out));
+        }
+
+        historyOutputPeak = std::max(historyOutputPeak, peak);
+    }
+
+    // No clip count here: the limiter clamps to its ceiling (at most full scale), so a peak
+    // at full scale is the limiter doing its job with a 0 dB ceiling, not a clip
+}
+
+bool CompressorEngine::canProcessAsMono(float* const* channels, int startSample, int numSamples, int numChannels, bool fading) const
+{
+    if (numChannels < 2)
+        return false;
+
+    const size_t bytes = static_cast<size_t>(numSamples) * sizeof(float);
+    auto sameBits = [](float a, float b) { return std::memcmp(&a, &b, sizeof(float)) == 0; };
+
+    for (int channel = 1; channel < numChannels; ++channel)
+    {
+        // Stereo material is rejected by the first compare, usually within a few samples
+        if (std::memcmp(channels[channel] + startSample, channels[0] + startSample, bytes) != 0
+            || std::memcmp(scScratch[channel], scScratch[0], bytes) != 0
+            || !sameBits(dcBlockerX1[channel], dcBlockerX1[0])
+            || !sameBits(dcBlockerY1[channel], dcBlockerY1[0])
+            || !stage1[channel].hasSameStateAs(stage1[0])
+            || (dualStage && !stage2[channel].hasSameStateAs(stage2[0])))
+            return false;
+
+        if (fading && (!fadeStage1[channel].hasSameStateAs(fadeStage1[0])
+                       || (dualStage && !fadeStage2[channel].hasSameStateAs(fadeStage2[0]))))
+            return false;
+    }
+
+    return true;
+}
+
+void CompressorEngine::replayStage(float* samples, int channel, int stageIndex, int numSamples, int numChannels)
+{
+    const int frameSize = getGainCurveFrameSize(numChannels, dualStage);
+    const float* column = gainCurveFrames + 1 + channel * (dualStage ? 2 : 1) + stageIndex;
+
+    for (int i = 0; i < numSamples; ++i)
+        replayGainScratch[i] = column[i * frameSize];
+
+    kernels->applyGainAndShape(samples, replayGainScratch, numSamples, topology);
+}
+
+void CompressorEngine::captureStage(const CompressorStage& stage, int channel, int stageIndex, int numSamples, int numChannels)
+{
+    const int frameSize = getGainCurveFrameSize(numChannels, dualStage);
+    float* column = gainCurveFrames + 1 + channel * (dualStage ? 2 : 1) + stageIndex;
+    const float* gain = stage.getAppliedGain();
+
+    for (int i = 0; i < numSamples; ++i)
+        column[i * frameSize] = gain[i];
+}
+
+bool CompressorEngine::hasSameGainCurve(const mixcomp_params& a, const mixcomp_params& b)
+{
+    // Everything upstream of the stages' gains; makeup, mix, topology, the output stage and
+    // the quality settings (pinned to the full tier while capturing) are not
+    const bool sameStage2 = a.dual_stage == 0
+        || (a.threshold2_db == b.threshold2_db && a.ratio2 == b.ratio2
+            && a.attack2_ms == b.attack2_ms && a.release2_ms == b.release2_ms);
+
+    return a.sc_hpf_hz == b.sc_hpf_hz && a.sc_eq_shape == b.sc_eq_shape
+        && a.sc_eq_freq_hz == b.sc_eq_freq_hz && a.sc_eq_gain_db == b.sc_eq_gain_db
+        && a.threshold1_db == b.threshold1_db && a.ratio1 == b.ratio1
+        && a.attack1_ms == b.attack1_ms && a.release1_ms == b.release1_ms
+        && a.dual_stage == b.dual_stage && sameStage2
+        && a.knee_db == b.knee_db
+        && a.detector_rate == b.detector_rate && a.link_mode == b.link_mode
+        && a.true_peak_detect == b.true_peak_detect && a.double_precision == b.double_precision
+        && a.upward_threshold_db == b.upward_threshold_db && a.upward_ratio == b.upward_ratio
+        && a.expander_threshold_db == b.expander_threshold_db && a.expander_ratio == b.expander_ratio
+        && a.expander_range_db == b.expander_range_db;
+}
+
+void CompressorEngine::applyDetectorLink(int numSamples, int numChannels)
+{
+    float localPeak = 0.0f;
+    for (int channel = 0; channel < numChannels; ++channel)
+        for (int i = 0; i < numSamples; ++i)
+            localPeak = std::max(localPeak, std::fabs(scScratch[channel][i]));
+
+    detectorLink.publish(localPeak, linkTimestamp);
+
+    // Our own detector signal stays sample-accurate; the others arrive as a per-block level
+    // (the detectors rectify anyway, so the keyed signal can be a magnitude)
+    const bool sum = linkMode == MIXCOMP_LINK_SUM;
+    const float others = detectorLink.readOthers(sum, linkTimestamp);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* sc = scScratch[channel];
+
+        for (int i = 0; i < numSamples; ++i)
+            sc[i] = sum ? std::fabs(sc[i]) + others : std::max(std::fabs(sc[i]), others);
+    }
+}
+
+//==============================================================================
+void CompressorEngine::publishResources(std::unique_ptr<EngineResources> fresh)
+{
+    // A set the audio thread never picked up is simply superseded
+    delete pendingResources.exchange(fresh.release(), std::memory_order_acq_rel);
+}
+
+void CompressorEngine::collectRetiredResources()
+{
+    delete retiredResources.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+//==============================================================================
+void CompressorEngine::resetHistoryBin()
+{
+    historyGRMin = std::numeric_limits<float>::max();
+    historyGRMax = 0.0f;
+    historyInputPeak = 0.0f;
+    historyOutputPeak = 0.0f;
+}
+
+void CompressorEngine::pushHistoryBin()
+{
+    const int write = historyWritePos.load(std::memory_order_relaxed);
+    const int next = (write + 1) % historyFifoSize;
+
+    if (next != historyReadPos.load(std::memory_order_acquire))
+    {
+        auto& bin = historyFifo[write];
+        bin.grMin = historyGRMin;
+        bin.grMax = historyGRMax;
+        bin.inputPeakDB = gainToDecibels(historyInputPeak);
+        bin.outputPeakDB = gainToDecibels(historyOutputPeak);
+        historyWritePos.store(next, std::memory_order_release);
+    }
+
+    resetHistoryBin();
+}
+
+int CompressorEngine::readHistory(HistoryBin* dest, int maxBins)
+{
+    int read = historyReadPos.load(std::memory_order_relaxed);
+    const int write = historyWritePos.load(std::memory_order_acquire);
+    int numRead = 0;
+
+    while (read != write && numRead < maxBins)
+    {
+        dest[numRead++] = historyFifo[read];
+        read = (read + 1) % historyFifoSize;
+    }
+
+    historyReadPos.store(read, std::memory_order_release);
+    return numRead;
+}
+
+//==============================================================================
+float CompressorEngine::calculateAutoMakeup(float avgGainReduction)
+{
+    // Compensate with 3dB headroom margin (psychoacoustic optimization)
+    return avgGainReduction * 0.75f;
+}
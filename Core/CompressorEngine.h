@@ -0,0 +1,279 @@
+#pragma once
+
+#include "include/mixcomp.h"
+#include "CompressorStage.h"
+#include "DetectorLink.h"
+#include "EngineResources.h"
+#include "OutputLimiter.h"
+#include "QualityGovernor.h"
+#include "SidechainFilterBank.h"
+#include "Telemetry.h"
+#include "TruePeakDetector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+// The complete compressor: sidechain EQ, DC blocker, two compressor stages per channel,
+// auto makeup, parallel mix, soft clip or look-ahead limiter and metering. Free of JUCE; the plugin and the
+// C API are both thin wrappers around this class, so their output is bit-identical.
+//
+// Processing runs in sub-blocks on a fixed 32-sample grid that carries across calls, so
+// the output does not depend on how the caller slices the stream.
+class CompressorEngine
+{
+public:
+    static constexpr int subBlockSize = CompressorStage::maxBlockSize;
+    static constexpr int maxChannels = MIXCOMP_MAX_CHANNELS;
+
+    // One history bin: GR range and peak input/output levels over ~10ms (dB)
+    struct HistoryBin
+    {
+        float grMin = 0.0f, grMax = 0.0f;
+        float inputPeakDB = -100.0f, outputPeakDB = -100.0f;
+    };
+
+    CompressorEngine();
+    ~CompressorEngine();
+
+    // Allocation-free; sets the kernel variant, rates and clears all state. Not concurrent
+    // with process(); builds the first resource set inline from the current parameters.
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    // Snapshot taken at the next sub-block boundary
+    void setParameters(const mixcomp_params& newParams) { params = newParams; }
+    const mixcomp_params& getParameters() const { return params; }
+
+    // Planar, in place. Channels beyond the prepared count are left untouched.
+    void process(float* const* channels, int numChannels, int numSamples);
+
+    // Offline renders: process() with the side-chain run over the whole buffer first and the
+    // audio-rate detectors' envelopes evaluated by EnvelopeScan on numThreads threads
+    // (0 = all), bit-identical to process(). Allocates a side-chain and an envelope buffer per
+    // channel and stage. Plain process() runs while linked, replaying, on adaptive quality or
+    // background preparation, and whenever EnvelopeScan would get fewer than two threads
+    // (too few cores, or a buffer under two groups of chunks); a grid sub-block already begun
+    // is finished by process() first.
+    void processOffline(float* const* channels, int numChannels, int numSamples, int numThreads);
+
+    // DSP kernel variant: chosen from CPUID at prepare unless overridden (the
+    // MIXCOMP_KERNELS environment variable also overrides); applied at the next prepare
+    void setKernelVariantOverride(DSPKernels::Variant variant) { kernelVariantOverride = static_cast<int>(variant); }
+    void clearKernelVariantOverride() { kernelVariantOverride = -1; }
+    DSPKernels::Variant getKernelVariant() const { return kernels->variant; }
+
+    // Meters, safe to read from any thread
+    float getGainReduction() const { return currentGainReduction.load(std::memory_order_relaxed); }
+    float getInputRMS() const { return inputRMS.load(std::memory_order_relaxed); }
+    float getOutputRMS() const { return outputRMS.load(std::memory_order_relaxed); }
+
+    // Output limiter look-ahead while params.output_limiter is set (it follows the latest
+    // parameters, the audio switches at the next sub-block boundary)
+    int getLatencySamples() const { return params.output_limiter != 0 ? outputLimiter.getLatencySamples() : 0; }
+
+    // Adaptive quality (params.adaptive_quality): current QualityGovernor tier and smoothed
+    // load as a fraction of the deadline; safe to read from any thread
+    int getQualityTier() const { return qualityTier.load(std::memory_order_relaxed); }
+    float getCPULoad() const { return cpuLoad.load(std::memory_order_relaxed); }
+
+    // Detector link group (see DetectorLink); params.link_mode picks max or sum.
+    // Control thread only; returns false when the registry is full
+    bool setLinkGroup(const char* name) { return detectorLink.join(name); }
+
+    // Shared-memory telemetry (see Telemetry.h): enabling claims a slot in the machine-wide
+    // segment, after which every process() call publishes one record. Enable and disable are
+    // not concurrent with process(); the label may change at any time from a control thread.
+    bool enableTelemetry(const char* label) { return telemetry.attach(label); }
+    void disableTelemetry() { telemetry.detach(); }
+    void setTelemetryLabel(const char* label) { telemetry.setLabel(label); }
+
+    // Gain-curve capture and replay (see mixcomp_set_gain_curve_recorder): frames of
+    // getGainCurveFrameSize() floats per sample, handed out or pulled in per sub-block.
+    // Either one pins the full quality tier. Not concurrent with process().
+    void setGainCurveRecorder(mixcomp_gain_curve_recorder recorder, void* context) { gainCurveRecorder = recorder; gainCurveRecorderContext = context; }
+    void setGainCurvePlayer(mixcomp_gain_curve_player player, void* context) { gainCurvePlayer = player; gainCurvePlayerContext = context; }
+    static int getGainCurveFrameSize(int numChannels, bool dualStage) { return 1 + std::max(0, numChannels) * (dualStage ? 2 : 1); }
+    static bool hasSameGainCurve(const mixcomp_params& a, const mixcomp_params& b);
+
+    // Background preparation (set before prepare): resources are no longer rebuilt inside
+    // process(); a ResourceWorker publishes them and the engine swaps them in lock-free at
+    // its next sub-block boundary. Off by default, which keeps offline renders deterministic.
+    void setBackgroundPreparation(bool enabled) { backgroundPreparation = enabled; }
+
+    // Worker side: hand over a fresh set (replaces one not yet picked up) and free the
+    // sets the audio thread has swapped out. Never call these from the audio thread.
+    void publishResources(std::unique_ptr<EngineResources> fresh);
+    void collectRetiredResources();
+
+    // History bins captured by process(); single consumer, any thread. Bins are dropped
+    // when the consumer falls more than historyFifoSize bins behind.
+    int readHistory(HistoryBin* dest, int maxBins);
+    double getHistoryBinSeconds() const { return historyBinSeconds.load(std::memory_order_relaxed); }
+
+    // Linear ramp with the same semantics as juce::SmoothedValue<float, Linear>
+    struct LinearSmoothedValue
+    {
+        float current = 1.0f, target = 1.0f, step = 0.0f;
+        int stepsToTarget = 0, countdown = 0;
+
+        void reset(double sampleRate, double rampSeconds);
+        void setCurrentAndTargetValue(float value);
+        void setTargetValue(float value);
+        float getNextValue();
+    };
+
+    // Makeup ramp length, and the gain it heads for after a grid sub-block whose loudest
+    // combined GR was maxGainReductionDB (CompressorSweep steps its lanes the same way)
+    static constexpr double makeupRampSeconds = 0.05;
+    static float getMakeupTarget(float makeupDB, bool autoMakeup, float maxGainReductionDB);
+
+    // DC blocker pole on the input
+    static constexpr float dcBlockerA1 = 0.9997f;
+
+private:
+    //==============================================================================
+    mixcomp_params params;
+
+    double sampleRate = 44100.0;
+    int numPreparedChannels = 2;
+
+    // Parameter snapshot, refreshed once per sub-block
+    DSPKernels::Shaper topology = DSPKernels::Shaper::VCA;
+    bool dualStage = false;
+    float makeupDB = 0.0f;
+    bool autoMakeup = true;
+    float wetMix = 1.0f;
+    int linkMode = MIXCOMP_LINK_OFF;
+
+    int samplesUntilParameterUpdate = 0;
+    float dryScratch[maxChannels][subBlockSize] = {};
+    float scScratch[maxChannels][subBlockSize] = {};
+    float gr1Scratch[subBlockSize] = {};
+    float gr2Scratch[subBlockSize] = {};
+    float totalGRScratch[subBlockSize] = {};
+    float makeupScratch[subBlockSize] = {};
+    float subBlockMaxGR = 0.0f;     // accumulated across calls until the sub-block completes
+    float inputSqScratch[subBlockSize] = {};
+    float outputSqScratch[subBlockSize] = {};
+
+    // DSP components, one detector state per channel so channels never hand state to each other
+    CompressorStage stage1[maxChannels]; // Leveler
+    CompressorStage stage2[maxChannels]; // Peak catcher
+    SidechainFilterBank sidechainFilters;
+    TruePeakDetector truePeakDetector;
+    bool truePeakDetect = false;
+    OutputLimiter outputLimiter;
+    bool limiterEnabled = false;
+
+    // Linked detection: sub-block sidechain peaks shared with the other group members
+    DetectorLink detectorLink;
+    std::int64_t linkTimestamp = 0;
+
+    // Immutable resources in use. Inline mode rebuilds inlineResources in place; background
+    // mode swaps between heap sets through single-slot mailboxes (the audio thread only
+    // ever exchanges pointers, the worker owns every allocation and deletion)
+    EngineResources inlineResources;
+    const EngineResources* resources = &inlineResources;
+    std::atomic<EngineResources*> pendingResources{ nullptr };
+    std::atomic<EngineResources*> retiredResources{ nullptr };
+    bool backgroundPreparation = false;
+
+    // Adaptive quality: the governor picks a tier after each call; a change swaps the stages
+    // to the new tier while clones carry on with the old one and are faded out
+    QualityGovernor governor;
+    bool adaptiveQuality = false;
+    float cpuBudgetFraction = 0.1f;
+    int requestedTier = QualityGovernor::Full;
+    int activeTier = QualityGovernor::Full;
+    int fadeFromTier = QualityGovernor::Full;
+    int tierFadeRemaining = 0;
+    CompressorStage fadeStage1[maxChannels];
+    CompressorStage fadeStage2[maxChannels];
+    float fadeScratch[subBlockSize] = {};
+    float fadeGRScratch[subBlockSize] = {};
+    float fadeWeightScratch[subBlockSize] = {};
+    std::atomic<int> qualityTier{ QualityGovernor::Full };
+    std::atomic<float> cpuLoad{ 0.0f };
+    static constexpr int tierFadeSamples = 512;
+
+    // Gain-curve capture / replay; frames of one sub-block, interleaved per sample
+    mixcomp_gain_curve_recorder gainCurveRecorder = nullptr;
+    void* gainCurveRecorderContext = nullptr;
+    mixcomp_gain_curve_player gainCurvePlayer = nullptr;
+    void* gainCurvePlayerContext = nullptr;
+    float gainCurveFrames[subBlockSize * (1 + 2 * maxChannels)] = {};
+    float replayGainScratch[subBlockSize] = {};
+
+    // Telemetry publisher and the statistics only it reports
+    Telemetry::Publisher telemetry;
+    std::uint64_t clipCount = 0;
+    std::uint64_t callbackCount = 0;
+    float callbackMeanMicros = 0.0f;
+    float callbackMaxMicros = 0.0f;
+    static constexpr float callbackTimeSmoothing = 0.05f;
+
+    // processOffline's side-chain and stage envelopes for the whole call, indexed by sample
+    // within it; processSubBlock reads them while offlinePass is set. The buffer only grows
+    // and is left uninitialised (it can run to hundreds of megabytes).
+    std::unique_ptr<float[]> offlineBuffer;
+    size_t offlineBufferSize = 0;
+    const float* offlineSidechainData[maxChannels] = {};
+    const float* offlineEnvelopeData[2][maxChannels] = {};
+    bool offlinePass = false;
+
+    // Hot loops, dispatched to the best instruction set at prepare
+    const DSPKernels::KernelTable* kernels = DSPKernels::getBaselineKernels();
+    int kernelVariantOverride = -1;
+
+    // Metering
+    std::atomic<float> currentGainReduction{ 0.0f };
+    std::atomic<float> inputRMS{ 0.0f };
+    std::atomic<float> outputRMS{ 0.0f };
+    float grMeterEnvelope = 0.0f;   // instant attack, per-sample release
+    float grMeterReleaseCoef = 0.0f;
+    float inputMeanSquare = 0.0f;
+    float outputMeanSquare = 0.0f;
+    float rmsCoef = 0.0f;
+    static constexpr float grMeterReleaseSeconds = 0.3f;
+    static constexpr float rmsTimeConstantSeconds = 0.3f;
+
+    // Auto makeup gain with psychoacoustic headroom
+    LinearSmoothedValue makeupGainSmoothed;
+
+    // DC blocker to prevent offset issues
+    float dcBlockerX1[maxChannels] = {};
+    float dcBlockerY1[maxChannels] = {};
+
+    // History capture: a pending bin per ~10ms, handed over through a wait-free SPSC ring
+    static constexpr int historyFifoSize = 2048;
+    static constexpr double historyBinTargetSeconds = 0.01;
+    HistoryBin historyFifo[historyFifoSize];
+    std::atomic<int> historyWritePos{ 0 }, historyReadPos{ 0 };
+    int historySubBlocksPerBin = 1;
+    int historySubBlocksRemaining = 1;
+    float historyGRMin = 0.0f, historyGRMax = 0.0f;
+    float historyInputPeak = 0.0f, historyOutputPeak = 0.0f;
+    std::atomic<double> historyBinSeconds{ historyBinTargetSeconds };
+
+    void updateResources();
+    void updateParameters();
+    void configureStages(CompressorStage* firstStages, CompressorStage* secondStages, int tier);
+    void beginTierChange(int newTier);
+    void updateMakeupTarget();
+    void processSubBlock(float* const* channels, int startSample, int numSamples, int numChannels);
+    void precomputeOffline(float* const* channels, int numChannels, int numSamples, int numThreads);
+    const float* getOfflineEnvelope(int stageIndex, int channel, int startSample) const;
+    void mixAndSoftClip(float* const* channels, int startSample, int numSamples, int numChannels, int numProcessedChannels, float channelWeight);
+    void mixAndLimit(float* const* channels, int startSample, int numSamples, int numChannels, int numProcessedChannels, float channelWeight);
+    bool canProcessAsMono(float* const* channels, int startSample, int numSamples, int numChannels, bool fading) const;
+    void applyDetectorLink(int numSamples, int numChannels);
+    void replayStage(float* samples, int channel, int stageIndex, int numSamples, int numChannels);
+    void captureStage(const CompressorStage& stage, int channel, int stageIndex, int numSamples, int numChannels);
+    void resetHistoryBin();
+    void pushHistoryBin();
+    void publishTelemetry(double elapsedSeconds, int numSamples);
+
+    static float calculateAutoMakeup(float avgGainReduction);
+};
@@ -0,0 +1,267 @@
+#include "CompressorStage.h"
+#include "EnvelopeScan.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+//==============================================================================
+// CompressorStage Implementation with Topology Modeling
+void CompressorStage::prepare(double sr, const DSPKernels::KernelTable& kernelTable)
+{
+    sampleRate = sr;
+    kernels = &kernelTable;
+    lastAttackMs = -1.0f;
+    lastReleaseMs = -1.0f;
+    reset();
+}
+
+void CompressorStage::setParameters(const DSPKernels::CurveParams& newCurve, float attack, float release)
+{
+    curve = newCurve;
+
+    if (attack == lastAttackMs && release == lastReleaseMs)
+        return;
+
+    lastAttackMs = attack;
+    lastReleaseMs = release;
+
+    // Time constant conversion with safe bounds
+    float attackMs = std::max(minAttackMs, attack);
+    float releaseMs = std::max(minReleaseMs, release);
+
+    // In control-rate mode the one-pole steps once per controlRateFactor samples
+    const float stepsPerUpdate = static_cast<float>(controlRateFactor);
+    attackCoef = detectorCoefficient(attackMs, stepsPerUpdate, sampleRate);
+    releaseCoef = detectorCoefficient(releaseMs, stepsPerUpdate, sampleRate);
+
+    const double steps = static_cast<double>(controlRateFactor);
+    preciseAttackCoef = std::clamp(1.0 - std::exp(-steps / (attackMs * 0.001 * sampleRate)), 0.0001, 0.9999);
+    preciseReleaseCoef = std::clamp(1.0 - std::exp(-steps / (releaseMs * 0.001 * sampleRate)), 0.0001, 0.9999);
+}
+
+float CompressorStage::detectorCoefficient(float timeMs, float stepsPerUpdate, double sr)
+{
+    const float coef = 1.0f - std::exp(-stepsPerUpdate / (timeMs * 0.001f * static_cast<float>(sr)));
+    return std::clamp(coef, 0.0001f, 0.9999f);
+}
+
+void CompressorStage::setHighPrecision(bool enabled)
+{
+    // The double state picks up from the float state when the high-precision path next runs
+    if (enabled && !highPrecision)
+        preciseStateCurrent = false;
+
+    highPrecision = enabled;
+}
+
+void CompressorStage::setControlRate(int factor)
+{
+    factor = std::clamp(factor, 1, maxControlRateFactor);
+    if (factor == controlRateFactor)
+        return;
+
+    controlRateFactor = factor;
+    controlPhase = 0;
+    controlPeak = 0.0f;
+    gainStep = 0.0f;
+    grStep = 0.0f;
+
+    // Coefficients depend on the update rate
+    lastAttackMs = -1.0f;
+    lastReleaseMs = -1.0f;
+}
+
+int CompressorStage::chooseControlRate(float attackMs, float releaseMs, double sr)
+{
+    // Error bound: the control period is at most 1/64 of the fastest time constant, so the
+    // envelope moves by under 1 - exp(-1/64) = 1.6% of any step between control points and the
+    // interpolated gain stays within 0.3 dB of the per-sample gain for steps up to 20 dB.
+    // The peak-held sidechain never under-reads a transient; the gain lags by at most N samples.
+    const double fastestSamples = std::min(std::max(minAttackMs, attackMs), std::max(minReleaseMs, releaseMs)) * 0.001 * sr;
+
+    for (int factor = maxControlRateFactor; factor >= 4; factor /= 2)
+        if (factor * 64.0 <= fastestSamples)
+            return factor;
+
+    return 1;
+}
+
+void CompressorStage::precomputeEnvelope(const float* sc, float* env, std::int64_t numSamples, int numThreads) const
+{
+    assert(canPrecomputeEnvelope());
+    EnvelopeScan::process(*kernels, sc, env, numSamples, peakEnvelope, attackCoef, releaseCoef, numThreads);
+}
+
+void CompressorStage::processBlock(float* samples, const float* sc, float* grOut, int numSamples, DSPKernels::Shaper shaper,
+                                   const float* precomputedEnvelope)
+{
+    assert(numSamples <= maxBlockSize);
+    assert(precomputedEnvelope == nullptr || canPrecomputeEnvelope());
+
+    if (controlRateFactor > 1)
+    {
+        preciseStateCurrent = false;
+        processBlockControlRate(samples, sc, grOut, numSamples, shaper);
+        return;
+    }
+
+    if (highPrecision)
+    {
+        processBlockHighPrecision(samples, sc, grOut, numSamples, shaper);
+        return;
+    }
+
+    preciseStateCurrent = false;
+
+    // Pass 1: peak envelope follower on the sidechain (serial recurrence)
+    const float* env = envelope;
+
+    if (precomputedEnvelope != nullptr)
+    {
+        env = precomputedEnvelope;
+
+        if (numSamples > 0)
+            peakEnvelope = env[numSamples - 1];
+    }
+    else
+    {
+        MIXCOMP_TRACE_SCOPE("stage.envelope", numSamples);
+        peakEnvelope = kernels->envelope(sc, envelope, numSamples, peakEnvelope, attackCoef, releaseCoef);
+    }
+
+    // Pass 2: gain computer, independent per sample
+    {
+        MIXCOMP_TRACE_SCOPE("stage.gainCurve", numSamples);
+        computeGain(env, grOut, targetGain, numSamples);
+    }
+
+    if (numSamples > 0)
+        grCurrent = grOut[numSamples - 1];
+
+    // Pass 3: smooth gain changes, apply gain and topology shaping
+    MIXCOMP_TRACE_SCOPE("stage.smoothAndShape", numSamples);
+    gainSmooth = kernels->smoothGain(targetGain, targetGain, numSamples, gainSmooth, gainSmoothingCoef);
+    kernels->applyGainAndShape(samples, targetGain, numSamples, shaper);
+}
+
+void CompressorStage::processBlockHighPrecision(float* samples, const float* sc, float* grOut, int numSamples, DSPKernels::Shaper shaper)
+{
+    // Same passes as processBlock with the two recurrences carried in double
+    MIXCOMP_TRACE_SCOPE("stage.highPrecision", numSamples);
+
+    // Resuming after another path advanced the float state
+    if (!preciseStateCurrent)
+    {
+        preciseEnvelope = peakEnvelope;
+        preciseGain = gainSmooth;
+        preciseStateCurrent = true;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double detectorSignal = std::fabs(static_cast<double>(sc[i]));
+        const double coef = detectorSignal > preciseEnvelope ? preciseAttackCoef : preciseReleaseCoef;
+
+        preciseEnvelope = std::clamp(preciseEnvelope + (detectorSignal - preciseEnvelope) * coef, 0.0, 10.0);
+        envelope[i] = static_cast<float>(preciseEnvelope);
+    }
+
+    peakEnvelope = static_cast<float>(preciseEnvelope);
+
+    computeGain(envelope, grOut, targetGain, numSamples);
+
+    if (numSamples > 0)
+        grCurrent = grOut[numSamples - 1];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        preciseGain = std::clamp(preciseGain + (targetGain[i] - preciseGain) * static_cast<double>(gainSmoothingCoef),
+                                 static_cast<double>(DSPKernels::minGain), static_cast<double>(DSPKernels::maxGain));
+        targetGain[i] = static_cast<float>(preciseGain);
+    }
+
+    gainSmooth = static_cast<float>(preciseGain);
+    kernels->applyGainAndShape(samples, targetGain, numSamples, shaper);
+}
+
+void CompressorStage::processBlockControlRate(float* samples, const float* sc, float* grOut, int numSamples, DSPKernels::Shaper shaper)
+{
+    MIXCOMP_TRACE_SCOPE("stage.controlRate", numSamples);
+    const float rampScale = 1.0f / static_cast<float>(controlRateFactor);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Peak-hold decimation: the control-rate detector sees the loudest sample of each window
+        controlPeak = std::max(controlPeak, std::fabs(sc[i]));
+
+        if (++controlPhase == controlRateFactor)
+        {
+            controlPhase = 0;
+
+            if (controlPeak > peakEnvelope)
+                peakEnvelope += (controlPeak - peakEnvelope) * attackCoef;
+            else
+                peakEnvelope += (controlPeak - peakEnvelope) * releaseCoef;
+
+            peakEnvelope = std::clamp(peakEnvelope, 0.0f, 10.0f);
+            controlPeak = 0.0f;
+
+            float gainReductionDB, newGain;
+            computeGain(&peakEnvelope, &gainReductionDB, &newGain, 1);
+
+            // Ramp linearly to the new control point over the next window
+            gainStep = (newGain - gainSmooth) * rampScale;
+            grStep = (gainReductionDB - grCurrent) * rampScale;
+        }
+
+        gainSmooth = std::clamp(gainSmooth + gainStep, DSPKernels::minGain, DSPKernels::maxGain);
+        grCurrent += grStep;
+        grOut[i] = grCurrent;
+        targetGain[i] = gainSmooth;
+    }
+
+    kernels->applyGainAndShape(samples, targetGain, numSamples, shaper);
+}
+
+void CompressorStage::computeGain(const float* env, float* grDB, float* gain, int numSamples) const
+{
+    if (curveTable != nullptr && curveTable->curve == curve)
+        kernels->gainCurveTable(env, grDB, gain, numSamples, *curveTable);
+    else
+        kernels->gainCurve(env, grDB, gain, numSamples, curve);
+}
+
+bool CompressorStage::hasSameStateAs(const CompressorStage& other) const
+{
+    auto same = [](const auto& a, const auto& b) { return std::memcmp(&a, &b, sizeof(a)) == 0; };
+
+    return same(peakEnvelope, other.peakEnvelope)
+        && same(gainSmooth, other.gainSmooth)
+        && controlRateFactor == other.controlRateFactor
+        && controlPhase == other.controlPhase
+        && same(controlPeak, other.controlPeak)
+        && same(gainStep, other.gainStep)
+        && same(grCurrent, other.grCurrent)
+        && same(grStep, other.grStep)
+        && highPrecision == other.highPrecision
+        && preciseStateCurrent == other.preciseStateCurrent
+        && same(preciseEnvelope, other.preciseEnvelope)
+        && same(preciseGain, other.preciseGain);
+}
+
+void CompressorStage::reset()
+{
+    peakEnvelope = 0.0f;
+    gainSmooth = 1.0f;
+    controlPhase = 0;
+    controlPeak = 0.0f;
+    gainStep = 0.0f;
+    grCurrent = 0.0f;
+    grStep = 0.0f;
+    preciseEnvelope = 0.0;
+    preciseGain = 1.0;
+    preciseStateCurrent = true;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "DSPKernels.h"
+
+#include <cstdint>
+
+//==============================================================================
+// Compressor stage with psychoacoustic modeling: peak detector on the sidechain,
+// multi-segment gain computer, gain smoothing and topology shaping.
+// Processes in passes over blocks of up to maxBlockSize samples.
+class CompressorStage
+{
+public:
+    static constexpr int maxBlockSize = 32;
+
+    void prepare(double sampleRate, const DSPKernels::KernelTable& kernelTable);
+    // Processes up to maxBlockSize samples in place, writing per-sample GR (dB, negative while
+    // boosting) to grOut on every detector path.
+    // A precomputed envelope (see precomputeEnvelope) stands in for the detector pass.
+    void processBlock(float* samples, const float* sc, float* grOut, int numSamples, DSPKernels::Shaper shaper,
+                      const float* precomputedEnvelope = nullptr);
+    void reset();
+    // Bitwise comparison of the running state; settings are applied to every channel alike,
+    // so two stages in the same state produce identical output for identical input
+    bool hasSameStateAs(const CompressorStage& other) const;
+    // The curve comes sanitised (EngineResources::stageCurve)
+    void setParameters(const DSPKernels::CurveParams& newCurve, float attack, float release);
+
+    // Control-rate detection: 1 runs the detector and gain computer every sample, N > 1 runs
+    // them once per N samples on a peak-held sidechain and interpolates the gain back up
+    void setControlRate(int factor);
+    int getControlRate() const { return controlRateFactor; }
+
+    // Double-precision envelope and gain smoothing (audio-rate detection only; the
+    // control-rate path stays in float). State carries over when switching either way,
+    // including between detector rates while it stays on.
+    void setHighPrecision(bool enabled);
+
+    // Offline renders: the envelope processBlock would compute over the next numSamples of
+    // side-chain, from the current state and settings (EnvelopeScan, on numThreads threads).
+    // Audio-rate float detection only.
+    bool canPrecomputeEnvelope() const { return controlRateFactor == 1 && !highPrecision; }
+    void precomputeEnvelope(const float* sc, float* env, std::int64_t numSamples, int numThreads) const;
+
+    // Gain curve lookup (cheaper quality tiers): used while the table was built for the
+    // stage's current curve, otherwise the exact curve runs. nullptr always runs exact.
+    void setGainCurveTable(const DSPKernels::GainCurveTable* table) { curveTable = table; }
+    const DSPKernels::CurveParams& getCurve() const { return curve; }
+
+    // Linear gains the last processBlock applied, before shaping
+    const float* getAppliedGain() const { return targetGain; }
+
+    // Largest control-rate factor whose error stays under the documented bound
+    static int chooseControlRate(float attackMs, float releaseMs, double sampleRate);
+    static constexpr int maxControlRateFactor = 16;
+
+    // Detector one-pole coefficient for a time constant, stepping once per stepsPerUpdate
+    // samples; time constants are bounded below by minAttackMs / minReleaseMs first
+    static float detectorCoefficient(float timeMs, float stepsPerUpdate, double sampleRate);
+    static constexpr float minAttackMs = 0.1f;
+    static constexpr float minReleaseMs = 20.0f;
+
+    // Gain smoothing to prevent clicks
+    static constexpr float gainSmoothingCoef = 0.9999f;
+
+private:
+    // Peak detection with proper ballistics
+    float peakEnvelope = 0.0f;
+    float gainSmooth = 1.0f;
+
+    // Control-rate state (decimation phase carries across blocks)
+    int controlRateFactor = 1;
+    int controlPhase = 0;
+    float controlPeak = 0.0f;
+    float gainStep = 0.0f;
+    float grCurrent = 0.0f;
+    float grStep = 0.0f;
+
+    float attackCoef = 0.0f;
+    float releaseCoef = 0.0f;
+
+    // High-precision state and coefficients; the state is only current while the
+    // high-precision path ran last (any other path advances the float state alone)
+    bool highPrecision = false;
+    bool preciseStateCurrent = true;
+    double preciseEnvelope = 0.0;
+    double preciseGain = 1.0;
+    double preciseAttackCoef = 0.0;
+    double preciseReleaseCoef = 0.0;
+    DSPKernels::CurveParams curve;
+    double sampleRate = 44100.0;
+    const DSPKernels::KernelTable* kernels = DSPKernels::getBaselineKernels();
+    const DSPKernels::GainCurveTable* curveTable = nullptr;
+
+    // Last time constants the coefficients were derived from (skips the exps when unchanged)
+    float lastAttackMs = -1.0f;
+    float lastReleaseMs = -1.0f;
+
+    // Per-pass scratch
+    float envelope[maxBlockSize] = {};
+    float targetGain[maxBlockSize] = {};
+
+    void processBlockHighPrecision(float* samples, const float* sc, float* grOut, int numSamples, DSPKernels::Shaper shaper);
+    void processBlockControlRate(float* samples, const float* sc, float* grOut, int numSamples, DSPKernels::Shaper shaper);
+    void computeGain(const float* env, float* grDB, float* gain, int numSamples) const;
+};
@@ -0,0 +1,421 @@
+#include "CompressorSweep.h"
+#include "ScopedFlushDenormals.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+
+//==============================================================================
+bool CompressorSweep::canShare(const mixcomp_params& a, const mixcomp_params& b)
+{
+    return std::clamp(a.topology, 0, 2) == std::clamp(b.topology, 0, 2)
+        && (a.dual_stage != 0) == (b.dual_stage != 0)
+        && a.sc_hpf_hz == b.sc_hpf_hz && std::clamp(a.sc_eq_shape, 0, 2) == std::clamp(b.sc_eq_shape, 0, 2)
+        && a.sc_eq_freq_hz == b.sc_eq_freq_hz && a.sc_eq_gain_db == b.sc_eq_gain_db
+        && (a.true_peak_detect != 0) == (b.true_peak_detect != 0);
+}
+
+bool CompressorSweep::prepare(double newSampleRate, int newNumChannels, const mixcomp_params* variants, int newNumVariants)
+{
+    assert(newNumChannels >= 1 && newNumChannels <= maxChannels);
+    assert(newNumVariants >= 1 && newNumVariants <= maxVariants);
+
+    for (int v = 1; v < newNumVariants; ++v)
+        if (!canShare(variants[0], variants[v]))
+            return false;
+
+    sampleRate = newSampleRate;
+    numChannels = newNumChannels;
+    numVariants = newNumVariants;
+    kernels = &DSPKernels::getKernels(DSPKernels::getPreferredVariant());
+
+    const auto& shared = variants[0];
+    topology = static_cast<DSPKernels::Shaper>(std::clamp(shared.topology, 0, 2));
+    dualStage = shared.dual_stage != 0;
+    truePeakDetect = shared.true_peak_detect != 0;
+
+    // Side-chain EQ snaps to its design, as the engine's does on its first sub-block
+    mixcomp_params sharedOnly = shared;
+    sharedOnly.adaptive_quality = 0;
+    resources.build(EngineResources::Key::fromParameters(sharedOnly, sampleRate));
+    sidechainFilters.prepare();
+    sidechainFilters.setDesign(resources.sidechain);
+
+    // Same coefficients and curves CompressorStage derives at the audio rate
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        stage1[ch] = {};
+        stage2[ch] = {};
+        stage1[ch].numLanes = stage2[ch].numLanes = numVariants;
+    }
+
+    for (int v = 0; v < numVariants; ++v)
+    {
+        const auto& params = variants[v];
+        const auto curve1 = EngineResources::stageCurve(params, 0);
+        const auto curve2 = EngineResources::stageCurve(params, 1);
+        const float attack1 = CompressorStage::detectorCoefficient(std::max(CompressorStage::minAttackMs, params.attack1_ms), 1.0f, sampleRate);
+        const float release1 = CompressorStage::detectorCoefficient(std::max(CompressorStage::minReleaseMs, params.release1_ms), 1.0f, sampleRate);
+        const float attack2 = CompressorStage::detectorCoefficient(std::max(CompressorStage::minAttackMs, params.attack2_ms), 1.0f, sampleRate);
+        const float release2 = CompressorStage::detectorCoefficient(std::max(CompressorStage::minReleaseMs, params.release2_ms), 1.0f, sampleRate);
+
+        if (useCurveTablesRequested)
+        {
+            DSPKernels::buildGainCurveTable(curveTables[0][v], curve1);
+            DSPKernels::buildGainCurveTable(curveTables[1][v], curve2);
+        }
+
+        for (int ch = 0; ch < maxChannels; ++ch)
+        {
+            stage1[ch].curve[v] = curve1;
+            stage1[ch].attackCoef[v] = attack1;
+            stage1[ch].releaseCoef[v] = release1;
+            stage2[ch].curve[v] = curve2;
+            stage2[ch].attackCoef[v] = attack2;
+            stage2[ch].releaseCoef[v] = release2;
+            stage1[ch].curveTable[v] = useCurveTablesRequested ? &curveTables[0][v] : nullptr;
+            stage2[ch].curveTable[v] = useCurveTablesRequested ? &curveTables[1][v] : nullptr;
+        }
+
+        wetMix[v] = params.mix_percent / 100.0f;
+        dryMix[v] = 1.0f - wetMix[v];
+        makeupDB[v] = params.makeup_db;
+        autoMakeup[v] = params.auto_makeup != 0;
+        makeupGainSmoothed[v].reset(sampleRate, CompressorEngine::makeupRampSeconds);
+    }
+
+    kShelf = designKWeighting(sampleRate, true);
+    kHighPass = designKWeighting(sampleRate, false);
+    segmentLength = std::max(1, static_cast<int>(std::lround(sampleRate * 0.1)));
+
+    reset();
+    return true;
+}
+
+void CompressorSweep::reset()
+{
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        std::fill(std::begin(stage1[ch].envelope), std::end(stage1[ch].envelope), 0.0f);
+        std::fill(std::begin(stage1[ch].gainSmooth), std::end(stage1[ch].gainSmooth), 1.0f);
+        std::fill(std::begin(stage2[ch].envelope), std::end(stage2[ch].envelope), 0.0f);
+        std::fill(std::begin(stage2[ch].gainSmooth), std::end(stage2[ch].gainSmooth), 1.0f);
+        dcBlockerX1[ch] = 0.0f;
+        dcBlockerY1[ch] = 0.0f;
+    }
+
+    sidechainFilters.reset();
+    truePeakDetector.reset();
+
+    for (int v = 0; v < lanes; ++v)
+    {
+        makeupGainSmoothed[v].setCurrentAndTargetValue(1.0f);
+        subBlockMaxGR[v] = 0.0f;
+        grSum[v] = 0.0;
+        grMax[v] = 0.0f;
+        grActiveSamples[v] = 0;
+        outputPeak[v] = 0.0f;
+        segmentEnergy[v] = 0.0;
+    }
+
+    samplesUntilMakeupUpdate = subBlockSize;
+    samplesMeasured = 0;
+
+    for (auto& channelState : kState)
+        for (auto& filterState : channelState)
+            std::fill(std::begin(filterState), std::end(filterState), 0.0);
+
+    for (auto& segment : recentSegments)
+        std::fill(std::begin(segment), std::end(segment), 0.0);
+
+    for (int v = 0; v < lanes; ++v)
+    {
+        std::fill(std::begin(blockCounts[v]), std::end(blockCounts[v]), 0);
+        std::fill(std::begin(blockPowers[v]), std::end(blockPowers[v]), 0.0);
+    }
+
+    segmentPosition = 0;
+    segmentsSeen = 0;
+}
+
+void CompressorSweep::process(const float* const* input, float* const* outputs, int numSamples)
+{
+    ScopedFlushDenormals noDenormals;
+    MIXCOMP_TRACE_SCOPE("sweep", numSamples);
+
+    // Same fixed grid as the engine: makeup targets move only at whole sub-blocks
+    int position = 0;
+    while (position < numSamples)
+    {
+        const int numThisTime = std::min(numSamples - position, samplesUntilMakeupUpdate);
+        processSubBlock(input, outputs, position, numThisTime);
+
+        position += numThisTime;
+        samplesUntilMakeupUpdate -= numThisTime;
+
+        if (samplesUntilMakeupUpdate == 0)
+        {
+            for (int v = 0; v < numVariants; ++v)
+            {
+                makeupGainSmoothed[v].setTargetValue(CompressorEngine::getMakeupTarget(makeupDB[v], autoMakeup[v], subBlockMaxGR[v]));
+                subBlockMaxGR[v] = 0.0f;
+            }
+
+            samplesUntilMakeupUpdate = subBlockSize;
+        }
+    }
+}
+
+void CompressorSweep::processSubBlock(const float* const* input, float* const* outputs, int startSample, int numSamples)
+{
+    assert(numSamples <= subBlockSize);
+    const int laneSamples = numSamples * lanes;
+
+    // Detector EQ and true peak once for every variant
+    const float* scInputs[maxChannels] = {};
+    float* scOutputs[maxChannels] = {};
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        scInputs[channel] = input[channel] + startSample;
+        scOutputs[channel] = scScratch[channel];
+    }
+
+    sidechainFilters.process(scInputs, scOutputs, numChannels, numSamples);
+
+    if (truePeakDetect)
+        truePeakDetector.process(scOutputs, numChannels, numSamples);
+
+    std::fill(totalGRScratch, totalGRScratch + laneSamples, 0.0f);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* dryData = dryScratch[channel];
+        auto* wetData = wetScratch[channel];
+
+        // The DC-blocked input is the same for every variant; each lane starts from a copy
+        float blocked[subBlockSize];
+        std::copy(input[channel] + startSample, input[channel] + startSample + numSamples, dryData);
+        std::copy(dryData, dryData + numSamples, blocked);
+        kernels->dcBlock(blocked, discardScratch, numSamples, dcBlockerX1[channel], dcBlockerY1[channel],
+                         CompressorEngine::dcBlockerA1, 0.0f);
+
+        for (int i = 0; i < numSamples; ++i)
+            std::fill(wetData + i * lanes, wetData + (i + 1) * lanes, blocked[i]);
+
+        {
+            MIXCOMP_TRACE_SCOPE("sweep.lanes", numSamples);
+            kernels->laneStage(scScratch[channel], wetData, gr1Scratch, numSamples, stage1[channel],
+                               CompressorStage::gainSmoothingCoef, topology);
+
+            if (dualStage)
+                kernels->laneStage(scScratch[channel], wetData, gr2Scratch, numSamples, stage2[channel],
+                                   CompressorStage::gainSmoothingCoef, topology);
+        }
+
+        // Loudest channel drives each variant's makeup
+        for (int j = 0; j < laneSamples; ++j)
+            totalGRScratch[j] = std::max(totalGRScratch[j], gr1Scratch[j] + (dualStage ? gr2Scratch[j] : 0.0f));
+    }
+
+    for (int v = 0; v < numVariants; ++v)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float gr = totalGRScratch[i * lanes + v];
+            subBlockMaxGR[v] = std::max(subBlockMaxGR[v], gr);
+            grSum[v] += gr;
+            grMax[v] = std::max(grMax[v], gr);
+            grActiveSamples[v] += gr > grActiveThresholdDB ? 1 : 0;
+            makeupScratch[i * lanes + v] = makeupGainSmoothed[v].getNextValue();
+        }
+    }
+
+    // Parallel mix and soft clip, as the engine's mixAndClip kernel
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* dryData = dryScratch[channel];
+        auto* wetData = wetScratch[channel];
+
+        for (int i = 0; i < numSamples; ++i)
+            for (int v = 0; v < numVariants; ++v)
+            {
+                const int j = i * lanes + v;
+                wetData[j] = (wetData[j] * makeupScratch[j]) * wetMix[v] + dryData[i] * dryMix[v];
+            }
+
+        kernels->softClip(wetData, numSamples * lanes);
+
+        for (int i = 0; i < numSamples; ++i)
+            for (int v = 0; v < numVariants; ++v)
+                outputPeak[v] = std::max(outputPeak[v], std::fabs(wetData[i * lanes + v]));
+
+        if (outputs != nullptr)
+            for (int v = 0; v < numVariants; ++v)
+            {
+                auto* dest = outputs[v * numChannels + channel] + startSample;
+                for (int i = 0; i < numSamples; ++i)
+                    dest[i] = wetData[i * lanes + v];
+            }
+    }
+
+    measure(numSamples);
+    samplesMeasured += numSamples;
+}
+
+void CompressorSweep::measure(int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        double power[lanes] = {};
+
+        // Unused lanes filter silence, which keeps the loop a fixed width
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float* outputData = wetScratch[channel] + i * lanes;
+            auto& state = kState[channel];
+
+            for (int v = 0; v < lanes; ++v)
+            {
+                const double x = v < numVariants ? static_cast<double>(outputData[v]) : 0.0;
+
+                // Transposed direct form II
+                const double shelved = kShelf.b0 * x + state[0][v];
+                state[0][v] = kShelf.b1 * x - kShelf.a1 * shelved + state[1][v];
+                state[1][v] = kShelf.b2 * x - kShelf.a2 * shelved;
+
+                const double weighted = kHighPass.b0 * shelved + state[2][v];
+                state[2][v] = kHighPass.b1 * shelved - kHighPass.a1 * weighted + state[3][v];
+                state[3][v] = kHighPass.b2 * shelved - kHighPass.a2 * weighted;
+
+                power[v] += weighted * weighted;
+            }
+        }
+
+        for (int v = 0; v < lanes; ++v)
+            segmentEnergy[v] += power[v];
+
+        if (++segmentPosition == segmentLength)
+            closeSegment();
+    }
+}
+
+void CompressorSweep::closeSegment()
+{
+    auto& newest = recentSegments[segmentsSeen % segmentsPerBlock];
+    for (int v = 0; v < lanes; ++v)
+    {
+        newest[v] = segmentEnergy[v];
+        segmentEnergy[v] = 0.0;
+    }
+
+    segmentPosition = 0;
+
+    // A 400 ms block ends every 100 ms once the first four segments are in
+    if (++segmentsSeen < segmentsPerBlock)
+        return;
+
+    const double blockLength = static_cast<double>(segmentsPerBlock) * segmentLength;
+
+    for (int v = 0; v < numVariants; ++v)
+    {
+        double energy = 0.0;
+        for (auto& segment : recentSegments)
+            energy += segment[v];
+
+        const double power = energy / blockLength;
+        const double loudness = power > 0.0 ? -0.691 + 10.0 * std::log10(power) : absoluteGateLUFS;
+
+        if (loudness <= absoluteGateLUFS)
+            continue;
+
+        const int bin = std::min(histogramBins - 1, static_cast<int>((loudness - absoluteGateLUFS) * histogramBinsPerLU));
+        ++blockCounts[v][bin];
+        blockPowers[v][bin] += power;
+    }
+}
+
+mixcomp_sweep_stats CompressorSweep::getStats(int variant) const
+{
+    mixcomp_sweep_stats stats = {};
+    assert(variant >= 0 && variant < numVariants);
+
+    auto toDecibels = [](double power) { return static_cast<float>(-0.691 + 10.0 * std::log10(power)); };
+
+    // Gated integrated loudness: the relative gate sits 10 LU under the mean of the blocks
+    // above the absolute gate; blocks sharing the gate's 0.1 LU bin are counted as above it
+    std::int64_t count = 0;
+    double total = 0.0;
+    for (int bin = 0; bin < histogramBins; ++bin)
+    {
+        count += blockCounts[variant][bin];
+        total += blockPowers[variant][bin];
+    }
+
+    stats.loudness_lufs = -100.0f;
+
+    if (count > 0)
+    {
+        const double relativeGate = toDecibels(total / static_cast<double>(count)) + relativeGateLU;
+        const int firstBin = std::max(0, static_cast<int>(std::floor((relativeGate - absoluteGateLUFS) * histogramBinsPerLU)));
+
+        std::int64_t gatedCount = 0;
+        double gatedTotal = 0.0;
+        for (int bin = firstBin; bin < histogramBins; ++bin)
+        {
+            gatedCount += blockCounts[variant][bin];
+            gatedTotal += blockPowers[variant][bin];
+        }
+
+        if (gatedCount > 0)
+            stats.loudness_lufs = toDecibels(gatedTotal / static_cast<double>(gatedCount));
+    }
+
+    stats.output_peak_db = outputPeak[variant] > 0.0f ? std::max(-100.0f, 20.0f * std::log10(outputPeak[variant])) : -100.0f;
+
+    if (samplesMeasured > 0)
+    {
+        stats.gr_mean_db = static_cast<float>(grSum[variant] / static_cast<double>(samplesMeasured));
+        stats.gr_active_percent = static_cast<float>(100.0 * static_cast<double>(grActiveSamples[variant]) / static_cast<double>(samplesMeasured));
+    }
+
+    stats.gr_max_db = grMax[variant];
+    return stats;
+}
+
+CompressorSweep::Biquad CompressorSweep::designKWeighting(double sr, bool shelf)
+{
+    // ITU-R BS.1770 pre-filter and RLB high-pass, re-derived for any sample rate
+    const double pi = 3.14159265358979323846;
+    Biquad b;
+
+    if (shelf)
+    {
+        const double gainDB = 3.999843853973347, f0 = 1681.974450955533, q = 0.7071752369554196;
+        const double k = std::tan(pi * f0 / sr);
+        const double vh = std::pow(10.0, gainDB / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        b.b0 = (vh + vb * k / q + k * k) / a0;
+        b.b1 = 2.0 * (k * k - vh) / a0;
+        b.b2 = (vh - vb * k / q + k * k) / a0;
+        b.a1 = 2.0 * (k * k - 1.0) / a0;
+        b.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    else
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(pi * f0 / sr);
+        const double a0 = 1.0 + k / q + k * k;
+
+        b.b0 = 1.0;
+        b.b1 = -2.0;
+        b.b2 = 1.0;
+        b.a1 = 2.0 * (k * k - 1.0) / a0;
+        b.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    return b;
+}
@@ -0,0 +1,179 @@
+#include "DSPKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+ #include <intrin.h>
+ #include <immintrin.h>
+#endif
+
+namespace DSPKernels
+{
+    namespace
+    {
+       #if defined(__x86_64__) || defined(_M_X64)
+        struct X86Features
+        {
+            bool avx2 = false;
+            bool avx512 = false;
+        };
+
+        X86Features queryX86Features()
+        {
+            X86Features features;
+
+           #if defined(_MSC_VER)
+            int regs[4] = {};
+            __cpuid(regs, 0);
+            const int maxLeaf = regs[0];
+
+            __cpuid(regs, 1);
+            const bool osxsave = (regs[2] & (1 << 27)) != 0;
+            const bool avx = (regs[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx || maxLeaf < 7)
+                return features;
+
+            const unsigned long long xcr0 = _xgetbv(0);
+            __cpuidex(regs, 7, 0);
+            const unsigned ebx = (unsigned)regs[1];
+           #else
+            unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+            __asm__ __volatile__("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(0), "c"(0));
+            const unsigned maxLeaf = eax;
+
+            __asm__ __volatile__("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(1), "c"(0));
+            const bool osxsave = (ecx & (1u << 27)) != 0;
+            const bool avx = (ecx & (1u << 28)) != 0;
+            if (!osxsave || !avx || maxLeaf < 7)
+                return features;
+
+            unsigned xcr0Low = 0, xcr0High = 0;
+            __asm__ __volatile__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            const unsigned long long xcr0 = ((unsigned long long)xcr0High << 32) | xcr0Low;
+
+            __asm__ __volatile__("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(7), "c"(0));
+           #endif
+
+            // The OS must save the wider register state as well as the CPU supporting it
+            const bool osYmm = (xcr0 & 0x6) == 0x6;
+            const bool osZmm = (xcr0 & 0xe6) == 0xe6;
+
+            const bool cpuAvx2 = (ebx & (1u << 5)) != 0;
+            const bool cpuAvx512 = (ebx & (1u << 16)) != 0   // F
+                                && (ebx & (1u << 17)) != 0   // DQ
+                                && (ebx & (1u << 30)) != 0   // BW
+                                && (ebx & (1u << 31)) != 0;  // VL
+
+            features.avx2 = osYmm && cpuAvx2;
+            features.avx512 = features.avx2 && osZmm && cpuAvx512;
+            return features;
+        }
+
+        const X86Features& getX86Features()
+        {
+            static const X86Features features = queryX86Features();
+            return features;
+        }
+       #endif
+
+        const KernelTable* tableFor(Variant variant)
+        {
+            switch (variant)
+            {
+            case Variant::AVX512:   return getAVX512Kernels();
+            case Variant::AVX2:     return getAVX2Kernels();
+            default:                break;
+            }
+
+            auto* baseline = getBaselineKernels();
+            return baseline->variant == variant ? baseline : nullptr;
+        }
+    }
+
+    bool isVariantAvailable(Variant variant)
+    {
+        if (tableFor(variant) == nullptr)
+            return false;
+
+       #if defined(__x86_64__) || defined(_M_X64)
+        if (variant == Variant::AVX512)
+            return getX86Features().avx512;
+        if (variant == Variant::AVX2)
+            return getX86Features().avx2;
+       #endif
+
+        return true;
+    }
+
+    Variant detectBestVariant()
+    {
+        if (isVariantAvailable(Variant::AVX512))
+            return Variant::AVX512;
+        if (isVariantAvailable(Variant::AVX2))
+            return Variant::AVX2;
+
+        return getBaselineKernels()->variant;
+    }
+
+    Variant getPreferredVariant()
+    {
+        if (auto* requested = std::getenv("MIXCOMP_KERNELS"))
+            for (int i = 0; i < (int)Variant::NumVariants; ++i)
+                if (std::strcmp(requested, getVariantName((Variant)i)) == 0)
+                    return (Variant)i;
+
+        return detectBestVariant();
+    }
+
+    const KernelTable& getKernels(Variant requested)
+    {
+        // Walk down from a wide request to the first variant this machine can run
+        if (requested == Variant::AVX512 || requested == Variant::AVX2)
+            for (int i = (int)requested; i >= (int)Variant::AVX2; --i)
+                if (isVariantAvailable((Variant)i))
+                    return *tableFor((Variant)i);
+
+        return *getBaselineKernels();
+    }
+
+    void buildGainCurveTable(GainCurveTable& table, CurveParams curve)
+    {
+        table.curve = curve;
+
+        // Sample the exact curve with the baseline kernel, one octave at a time
+        const auto& exact = *getBaselineKernels();
+        float levels[GainCurveTable::pointsPerOctave];
+
+        for (int start = 0; start < GainCurveTable::size; start += GainCurveTable::pointsPerOctave)
+        {
+            const int count = std::min(GainCurveTable::pointsPerOctave, GainCurveTable::size - start);
+
+            for (int i = 0; i < count; ++i)
+            {
+                const int point = start + i;
+                const int octave = point / GainCurveTable::pointsPerOctave;
+                const int step = point % GainCurveTable::pointsPerOctave;
+                levels[i] = std::ldexp(1.0f + static_cast<float>(step) / GainCurveTable::pointsPerOctave,
+                                       GainCurveTable::minExponent + octave);
+            }
+
+            exact.gainCurve(levels, table.grDB + start, table.gain + start, count, curve);
+        }
+    }
+
+    const char* getVariantName(Variant variant)
+    {
+        switch (variant)
+        {
+        case Variant::Generic:  return "generic";
+        case Variant::SSE2:     return "sse2";
+        case Variant::AVX2:     return "avx2";
+        case Variant::AVX512:   return "avx512";
+        case Variant::NEON:     return "neon";
+        default:                return "unknown";
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+// Hot DSP kernels, compiled once per instruction set and picked at runtime.
+// Deliberately free of JUCE so each variant's translation unit can be built with
+// its own target flags. Every variant runs the same operations in the same order
+// (no FMA contraction, no reassociation), so all variants are bit-identical.
+
+namespace DSPKernels
+{
+    enum class Variant
+    {
+        Generic = 0,    // portable build baseline
+        SSE2,           // x86 baseline
+        AVX2,
+        AVX512,
+        NEON,           // ARM baseline
+        NumVariants
+    };
+
+    enum class Shaper
+    {
+        VCA = 0,
+        FET,
+        Optical
+    };
+
+    // Static transfer function, evaluated from one envelope in one pass. From the top:
+    // soft-knee downward compression above thresholdDB, unity, optional upward compression
+    // below upwardThresholdDB (boost capped at maxUpwardGainDB), and optional downward
+    // expansion below expanderThresholdDB (cut capped at expanderRangeDB; a high ratio gates).
+    // A ratio of 1 turns a segment off.
+    struct CurveParams
+    {
+        float thresholdDB = -24.0f;
+        float ratio = 4.0f;
+        float kneeWidth = 6.0f;
+
+        float upwardThresholdDB = -40.0f;
+        float upwardRatio = 1.0f;
+
+        float expanderThresholdDB = -60.0f;
+        float expanderRatio = 1.0f;
+        float expanderRangeDB = 40.0f;
+
+        bool operator==(const CurveParams& other) const
+        {
+            return thresholdDB == other.thresholdDB && ratio == other.ratio && kneeWidth == other.kneeWidth
+                && upwardThresholdDB == other.upwardThresholdDB && upwardRatio == other.upwardRatio
+                && expanderThresholdDB == other.expanderThresholdDB && expanderRatio == other.expanderRatio
+                && expanderRangeDB == other.expanderRangeDB;
+        }
+    };
+
+    // Gain limits of the curve and of everything smoothing it: the floor (-40 dB) bounds the
+    // deepest expansion, the ceiling (+12 dB) the upward boost
+    constexpr float maxUpwardGainDB = 12.0f;
+    constexpr float maxExpanderRangeDB = 40.0f;
+    constexpr float minGain = 0.01f;
+    constexpr float maxGain = 3.9810717f;
+
+    // Gain curve sampled at 64 points per octave of envelope level, read back by linear
+    // interpolation in place of the per-sample log/exp2 (well under 0.01 dB off the exact
+    // curve). The index comes straight from the float's exponent and top mantissa bits.
+    struct GainCurveTable
+    {
+        static constexpr int log2PointsPerOctave = 6;
+        static constexpr int pointsPerOctave = 1 << log2PointsPerOctave;
+        static constexpr int minExponent = -20;     // below 2^-20 (-120 dB) no setting compresses
+        static constexpr int numOctaves = 24;       // up to 2^4, above the detector's clamp
+        static constexpr int size = numOctaves * pointsPerOctave + 1;
+
+        CurveParams curve;
+        float grDB[size];
+        float gain[size];
+    };
+
+    // Fills the table from the exact curve (not realtime: ~1500 log/exp2)
+    void buildGainCurveTable(GainCurveTable& table, CurveParams curve);
+
+    // A bank of compressor stages keyed from one side-chain, each lane with its own curve,
+    // time constants and state (one lane per CompressorSweep variant). Lane buffers hold
+    // sample i of lane l at i * maxLanes + l, so the recurrences step all lanes together.
+    // A lane computes exactly what an audio-rate CompressorStage with its settings does.
+    struct LaneStage
+    {
+        static constexpr int maxLanes = 16;
+        static constexpr int maxBlockSize = 32;
+
+        int numLanes = 0;       // lanes past this run unity gain and skip the curve
+        CurveParams curve[maxLanes];
+        const GainCurveTable* curveTable[maxLanes] = {};   // built for curve, or nullptr for exact
+        float attackCoef[maxLanes] = {};
+        float releaseCoef[maxLanes] = {};
+
+        float envelope[maxLanes] = {};
+        float gainSmooth[maxLanes] = {};
+
+        // Per-pass scratch
+        float envelopeScratch[maxBlockSize * maxLanes] = {};
+        float gainScratch[maxBlockSize * maxLanes] = {};
+    };
+
+    // Independent streams the envelopeLanes kernel runs side by side
+    constexpr int numEnvelopeLanes = 16;
+
+    struct KernelTable
+    {
+        Variant variant;
+
+        // Peak envelope follower on |sc|; returns the final envelope state
+        float (*envelope)(const float* sc, float* env, int numSamples, float state, float attackCoef, float releaseCoef);
+
+        // Envelope -> gain reduction (dB, negative while boosting) and linear target gain
+        void (*gainCurve)(const float* env, float* grDB, float* gain, int numSamples, CurveParams curve);
+
+        // Same from a precomputed table
+        void (*gainCurveTable)(const float* env, float* grDB, float* gain, int numSamples, const GainCurveTable& table);
+
+        // One-pole gain smoothing; returns the final smoothed gain
+        float (*smoothGain)(const float* target, float* smoothed, int numSamples, float state, float coef);
+
+        // samples = shaper(samples * gain)
+        void (*applyGainAndShape)(float* samples, const float* gain, int numSamples, Shaper shaper);
+
+        // wet = softclip(wet * makeup * wetMix + dry * (1 - wetMix)); adds weighted squares
+        // to sumSq and returns the block's peak magnitude
+        float (*mixAndClip)(float* wet, const float* dry, const float* makeup, float* sumSq, int numSamples, float wetMix, float weight);
+
+        // The soft clip mixAndClip applies, in place
+        void (*softClip)(float* samples, int numSamples);
+
+        // wet = wet * makeup * wetMix + dry * (1 - wetMix), unclipped (the output limiter follows)
+        void (*mix)(float* wet, const float* dry, const float* makeup, int numSamples, float wetMix);
+
+        // First-order DC blocker in place; adds weighted squares of the output to sumSq
+        void (*dcBlock)(float* samples, float* sumSq, int numSamples, float& x1, float& y1, float a1, float weight);
+
+        // One-pole mean-square integrator; returns the final state
+        float (*integrateMeanSquare)(const float* squares, int numSamples, float state, float coef);
+
+        // Every lane's envelope, gain curve, gain smoothing and shaping over up to
+        // LaneStage::maxBlockSize samples; samples and grDB are lane-interleaved
+        void (*laneStage)(const float* sc, float* samples, float* grDB, int numSamples, LaneStage& stage, float smoothingCoef, Shaper shaper);
+
+        // The envelope recurrence over numEnvelopeLanes separate streams at once: lane l runs
+        // sc[l] into env[l] from state[l], which is updated (EnvelopeScan's speculative chunks)
+        void (*envelopeLanes)(const float* const* sc, float* const* env, int numSamples, float* state, float attackCoef, float releaseCoef);
+    };
+
+    // Widest variant this CPU and OS support
+    Variant detectBestVariant();
+
+    // Variant to use: the MIXCOMP_KERNELS environment override if set
+    // (generic/sse2/avx2/avx512/neon), otherwise detectBestVariant()
+    Variant getPreferredVariant();
+
+    // Returns the requested variant, or the best supported one below it
+    const KernelTable& getKernels(Variant requested);
+
+    bool isVariantAvailable(Variant variant);
+    const char* getVariantName(Variant variant);
+
+    // Per instruction-set tables; nullptr when not built for this architecture
+    const KernelTable* getBaselineKernels();
+    const KernelTable* getAVX2Kernels();
+    const KernelTable* getAVX512Kernels();
+}
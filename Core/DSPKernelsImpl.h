@@ -0,0 +1,426 @@
+// Kernel bodies shared by every instruction-set variant.
+// Included exactly once by each DSPKernels_*.cpp inside its own namespace, after
+// that file has set its target options. Do not include anywhere else.
+//
+// The transcendentals are spelled out below instead of calling libm: plain float
+// arithmetic and bit operations, no branches, so the per-sample loops vectorize to the
+// variant's full width and every variant still rounds identically.
+
+static inline float floatFromBits(std::uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Natural log of a positive normal float (within 2e-6 absolute)
+static inline float logPositive(float x)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+
+    // x = m * 2^exponent with m in [sqrt(1/2), sqrt(2)), then ln(m) = 2 atanh(s)
+    int exponent = static_cast<int>(bits >> 23) - 127;
+    float m = floatFromBits((bits & 0x7fffffu) | 0x3f800000u);
+    const bool high = m > 1.41421356f;
+    const float halved = m * 0.5f;
+    m = high ? halved : m;
+    exponent += high ? 1 : 0;
+
+    const float f = m - 1.0f;
+    const float s = f / (2.0f + f);
+    const float s2 = s * s;
+    const float series = 1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f + s2 * (1.0f / 7.0f + s2 * (1.0f / 9.0f))));
+
+    return static_cast<float>(exponent) * 0.693147182f + 2.0f * s * series;
+}
+
+// 2^y, y clamped to the normal range (within 1 ulp)
+static inline float exp2Clamped(float y)
+{
+    y = y < -126.0f ? -126.0f : (127.0f < y ? 127.0f : y);
+
+    // Nearest integer n and e^(r ln 2) for the remainder r in [-1/2, 1/2]
+    const int n = static_cast<int>(y + 128.5f) - 128;
+    const float t = (y - static_cast<float>(n)) * 0.693147182f;
+    const float p = 1.0f + t * (1.0f + t * (0.5f + t * (1.0f / 6.0f + t * (1.0f / 24.0f + t * (1.0f / 120.0f
+                  + t * (1.0f / 720.0f + t * (1.0f / 5040.0f)))))));
+
+    return p * floatFromBits(static_cast<std::uint32_t>(n + 127) << 23);
+}
+
+// tanh within 2 ulp: Lambert's continued fraction near zero, (1 - e^-2|x|) / (1 + e^-2|x|)
+// beyond
+static inline float tanhOf(float x)
+{
+    const float a = std::fabs(x);
+    const float a2 = a * a;
+
+    float fraction = 13.0f;
+    fraction = 11.0f + a2 / fraction;
+    fraction = 9.0f + a2 / fraction;
+    fraction = 7.0f + a2 / fraction;
+    fraction = 5.0f + a2 / fraction;
+    fraction = 3.0f + a2 / fraction;
+    fraction = 1.0f + a2 / fraction;
+
+    const float e = exp2Clamped(a * -2.88539008f);
+    const float nearZero = a / fraction;
+    const float beyond = (1.0f - e) / (1.0f + e);
+    const float magnitude = a < 0.625f ? nearZero : beyond;
+
+    return x < 0.0f ? -magnitude : magnitude;
+}
+
+static float envelope(const float* sc, float* env, int numSamples, float state, float attackCoef, float releaseCoef)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float detectorSignal = std::fabs(sc[i]);
+        float coef = detectorSignal > state ? attackCoef : releaseCoef;
+
+        state += (detectorSignal - state) * coef;
+        state = state < 0.0f ? 0.0f : (10.0f < state ? 10.0f : state);
+        env[i] = state;
+    }
+
+    return state;
+}
+
+static void gainCurve(const float* env, float* grDB, float* gain, int numSamples, CurveParams curve)
+{
+    const float halfKnee = curve.kneeWidth * 0.5f;
+    const float slope = 1.0f - 1.0f / curve.ratio;
+
+    // Zero when the segment is off, which leaves the compression result untouched
+    const float upwardSlope = 1.0f - 1.0f / curve.upwardRatio;
+    const float expanderSlope = curve.expanderRatio - 1.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Convert to dB (-100 dB floor; the envelope is never negative)
+        float envDB = logPositive(env[i] + 1e-6f) * 8.68588964f;
+        envDB = envDB < -100.0f ? -100.0f : envDB;
+
+        // Above the knee, in the soft knee, or below it: selects rather than branches so the
+        // loop vectorizes (with a hard knee the knee term is never selected)
+        float overThreshold = envDB - curve.thresholdDB;
+        float kneeInput = overThreshold + halfKnee;
+        float kneeGR = (kneeInput * kneeInput) / (2.0f * curve.kneeWidth) * slope;
+        float gr = overThreshold >= halfKnee ? overThreshold * slope : (overThreshold > -halfKnee ? kneeGR : 0.0f);
+
+        gr = gr < 0.0f ? 0.0f : (60.0f < gr ? 60.0f : gr);
+
+        // Upward compression between the upward and expander thresholds; the boost holds its
+        // value below the expander threshold, where expansion takes over
+        float upwardInput = envDB > curve.expanderThresholdDB ? envDB : curve.expanderThresholdDB;
+        float belowUpward = curve.upwardThresholdDB - upwardInput;
+        float boost = belowUpward > 0.0f ? belowUpward * upwardSlope : 0.0f;
+        boost = maxUpwardGainDB < boost ? maxUpwardGainDB : boost;
+
+        // Range limits the net attenuation below unity, with the held boost included
+        float belowExpander = curve.expanderThresholdDB - envDB;
+        float cut = belowExpander > 0.0f ? belowExpander * expanderSlope : 0.0f;
+        float maxCut = curve.expanderRangeDB + boost;
+        cut = maxCut < cut ? maxCut : cut;
+
+        gr = (gr + cut) - boost;
+        grDB[i] = gr;
+        float linear = exp2Clamped(-gr * 0.166096404f);
+        gain[i] = -gr > -100.0f ? linear : 0.0f;
+    }
+}
+
+static void gainCurveTable(const float* env, float* grDB, float* gain, int numSamples, const GainCurveTable& table)
+{
+    constexpr int mantissaShift = 23 - GainCurveTable::log2PointsPerOctave;
+    constexpr unsigned fractionMask = (1u << mantissaShift) - 1u;
+    constexpr float fractionScale = 1.0f / static_cast<float>(1u << mantissaShift);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Envelope is never negative: exponent picks the octave, the next mantissa bits the
+        // point within it, and the remaining bits are linear in level between the two points
+        std::uint32_t bits;
+        std::memcpy(&bits, &env[i], sizeof(bits));
+
+        const int octave = static_cast<int>(bits >> 23) - 127 - GainCurveTable::minExponent;
+        int index = 0;
+        float fraction = 0.0f;
+
+        if (octave >= GainCurveTable::numOctaves)
+        {
+            index = GainCurveTable::size - 2;
+            fraction = 1.0f;
+        }
+        else if (octave >= 0)
+        {
+            index = octave * GainCurveTable::pointsPerOctave
+                  + static_cast<int>((bits >> mantissaShift) & (GainCurveTable::pointsPerOctave - 1));
+            fraction = static_cast<float>(bits & fractionMask) * fractionScale;
+        }
+
+        grDB[i] = table.grDB[index] + (table.grDB[index + 1] - table.grDB[index]) * fraction;
+        gain[i] = table.gain[index] + (table.gain[index + 1] - table.gain[index]) * fraction;
+    }
+}
+
+static float smoothGain(const float* target, float* smoothed, int numSamples, float state, float coef)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        state += (target[i] - state) * coef;
+        state = state < minGain ? minGain : (maxGain < state ? maxGain : state);
+        smoothed[i] = state;
+    }
+
+    return state;
+}
+
+static void applyGainAndShape(float* samples, const float* gain, int numSamples, Shaper shaper)
+{
+    switch (shaper)
+    {
+    case Shaper::VCA:
+        // Clean, odd harmonics (0.01-0.1% THD)
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x = samples[i] * gain[i];
+            samples[i] = x + (x * x * x) * 0.0005f;
+        }
+        break;
+
+    case Shaper::FET:
+        // 2nd + 3rd harmonics (0.1-0.5% THD)
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x = samples[i] * gain[i];
+            samples[i] = x + (x * x) * 0.002f + (x * x * x) * 0.003f;
+        }
+        break;
+
+    case Shaper::Optical:
+        // Smooth, program-dependent (0.05-0.3% THD)
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x = samples[i] * gain[i];
+            samples[i] = x + tanhOf(x * 2.0f) * 0.001f;
+        }
+        break;
+
+    default:
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] *= gain[i];
+        break;
+    }
+}
+
+static float mixAndClip(float* wet, const float* dry, const float* makeup, float* sumSq, int numSamples, float wetMix, float weight)
+{
+    const float dryMix = 1.0f - wetMix;
+    std::uint32_t peakBits = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float mixed = (wet[i] * makeup[i]) * wetMix + dry[i] * dryMix;
+
+        // Soft clip to prevent overshoots
+        float out = tanhOf(mixed * 0.9f) / 0.9f;
+        wet[i] = out;
+        sumSq[i] += out * out * weight;
+
+        // Magnitudes order like their bit patterns, and an integer max vectorizes
+        std::uint32_t bits;
+        std::memcpy(&bits, &out, sizeof(bits));
+        bits &= 0x7fffffffu;
+        peakBits = bits > peakBits ? bits : peakBits;
+    }
+
+    return floatFromBits(peakBits);
+}
+
+static void softClip(float* samples, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+        samples[i] = tanhOf(samples[i] * 0.9f) / 0.9f;
+}
+
+static void mix(float* wet, const float* dry, const float* makeup, int numSamples, float wetMix)
+{
+    const float dryMix = 1.0f - wetMix;
+
+    for (int i = 0; i < numSamples; ++i)
+        wet[i] = (wet[i] * makeup[i]) * wetMix + dry[i] * dryMix;
+}
+
+static void dcBlock(float* samples, float* sumSq, int numSamples, float& x1, float& y1, float a1, float weight)
+{
+    float xPrev = x1, yPrev = y1;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float x = samples[i];
+        float y = x - xPrev + (a1 * yPrev);
+        xPrev = x;
+        yPrev = y;
+
+        samples[i] = y;
+        sumSq[i] += y * y * weight;
+    }
+
+    x1 = xPrev;
+    y1 = yPrev;
+}
+
+static float integrateMeanSquare(const float* squares, int numSamples, float state, float coef)
+{
+    for (int i = 0; i < numSamples; ++i)
+        state += (squares[i] - state) * coef;
+
+    return state;
+}
+
+static void laneStage(const float* sc, float* samples, float* grDB, int numSamples, LaneStage& stage, float smoothingCoef, Shaper shaper)
+{
+    constexpr int lanes = LaneStage::maxLanes;
+    float* env = stage.envelopeScratch;
+    float* gain = stage.gainScratch;
+
+    // Pass 1: peak envelopes, the lanes side by side (same recurrence as envelope())
+    float state[lanes];
+    for (int l = 0; l < lanes; ++l)
+        state[l] = stage.envelope[l];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float detectorSignal = std::fabs(sc[i]);
+
+        for (int l = 0; l < lanes; ++l)
+        {
+            float coef = detectorSignal > state[l] ? stage.attackCoef[l] : stage.releaseCoef[l];
+            float s = state[l] + (detectorSignal - state[l]) * coef;
+            s = s < 0.0f ? 0.0f : (10.0f < s ? 10.0f : s);
+            state[l] = s;
+            env[i * lanes + l] = s;
+        }
+    }
+
+    for (int l = 0; l < lanes; ++l)
+        stage.envelope[l] = state[l];
+
+    // Pass 2: gain curve one lane at a time through the curve kernels (exact: log/exp2 per sample)
+    float column[LaneStage::maxBlockSize], columnGR[LaneStage::maxBlockSize], columnGain[LaneStage::maxBlockSize];
+
+    for (int l = 0; l < lanes; ++l)
+    {
+        if (l < stage.numLanes)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                column[i] = env[i * lanes + l];
+
+            if (stage.curveTable[l] != nullptr)
+                gainCurveTable(column, columnGR, columnGain, numSamples, *stage.curveTable[l]);
+            else
+                gainCurve(column, columnGR, columnGain, numSamples, stage.curve[l]);
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                columnGR[i] = 0.0f;
+                columnGain[i] = 1.0f;
+            }
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            grDB[i * lanes + l] = columnGR[i];
+            gain[i * lanes + l] = columnGain[i];
+        }
+    }
+
+    // Pass 3: gain smoothing side by side (same recurrence as smoothGain())
+    for (int l = 0; l < lanes; ++l)
+        state[l] = stage.gainSmooth[l];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int l = 0; l < lanes; ++l)
+        {
+            float s = state[l] + (gain[i * lanes + l] - state[l]) * smoothingCoef;
+            s = s < minGain ? minGain : (maxGain < s ? maxGain : s);
+            state[l] = s;
+            gain[i * lanes + l] = s;
+        }
+    }
+
+    for (int l = 0; l < lanes; ++l)
+        stage.gainSmooth[l] = state[l];
+
+    // Pass 4: gain and shaping are per sample, so the interleaved block is one flat run
+    applyGainAndShape(samples, gain, numSamples * lanes, shaper);
+}
+
+static void envelopeLanes(const float* const* sc, float* const* env, int numSamples, float* state, float attackCoef, float releaseCoef)
+{
+    constexpr int lanes = numEnvelopeLanes;
+    constexpr int tileLength = 32;
+    float tile[tileLength * lanes];
+    float laneState[lanes];
+
+    for (int l = 0; l < lanes; ++l)
+        laneState[l] = state[l];
+
+    // Streams are transposed through an interleaved tile so the recurrence steps every lane
+    // together (same arithmetic as envelope())
+    for (int start = 0; start < numSamples; start += tileLength)
+    {
+        const int length = numSamples - start < tileLength ? numSamples - start : tileLength;
+
+        for (int l = 0; l < lanes; ++l)
+            for (int i = 0; i < length; ++i)
+                tile[i * lanes + l] = sc[l][start + i];
+
+        for (int i = 0; i < length; ++i)
+        {
+            for (int l = 0; l < lanes; ++l)
+            {
+                float detectorSignal = std::fabs(tile[i * lanes + l]);
+                float coef = detectorSignal > laneState[l] ? attackCoef : releaseCoef;
+                float s = laneState[l] + (detectorSignal - laneState[l]) * coef;
+                s = s < 0.0f ? 0.0f : (10.0f < s ? 10.0f : s);
+                laneState[l] = s;
+                tile[i * lanes + l] = s;
+            }
+        }
+
+        for (int l = 0; l < lanes; ++l)
+            for (int i = 0; i < length; ++i)
+                env[l][start + i] = tile[i * lanes + l];
+    }
+
+    for (int l = 0; l < lanes; ++l)
+        state[l] = laneState[l];
+}
+
+static const KernelTable& makeTable(Variant variant)
+{
+    static const KernelTable table
+    {
+        variant,
+        envelope,
+        gainCurve,
+        gainCurveTable,
+        smoothGain,
+        applyGainAndShape,
+        mixAndClip,
+        softClip,
+        mix,
+        dcBlock,
+        integrateMeanSquare,
+        laneStage,
+        envelopeLanes
+    };
+
+    return table;
+}
@@ -0,0 +1,45 @@
+// AVX-512 kernels. GCC/Clang get the target from the pragmas below; with MSVC give this
+// file the /arch:AVX512 compiler flag scheme in the Projucer project.
+// FMA is intentionally not enabled so results stay bit-identical to the baseline.
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "DSPKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#if defined(__clang__)
+ #pragma clang attribute push (__attribute__((target("avx2,avx512f,avx512vl,avx512bw,avx512dq"))), apply_to = function)
+#elif defined(__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target("avx2,avx512f,avx512vl,avx512bw,avx512dq")
+#endif
+
+namespace DSPKernels
+{
+    namespace AVX512
+    {
+        #include "DSPKernelsImpl.h"
+    }
+}
+
+#if defined(__clang__)
+ #pragma clang attribute pop
+#elif defined(__GNUC__)
+ #pragma GCC pop_options
+#endif
+
+namespace DSPKernels
+{
+    const KernelTable* getAVX512Kernels()   { return &AVX512::makeTable(Variant::AVX512); }
+}
+
+#else
+
+namespace DSPKernels
+{
+    const KernelTable* getAVX512Kernels()   { return nullptr; }
+}
+
+#endif
@@ -0,0 +1,25 @@
+// Baseline kernels: built with the project's default flags (SSE2 on x86-64, NEON on AArch64)
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "DSPKernels.h"
+
+namespace DSPKernels
+{
+    namespace Baseline
+    {
+        #include "DSPKernelsImpl.h"
+    }
+
+    const KernelTable* getBaselineKernels()
+    {
+       #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        return &Baseline::makeTable(Variant::SSE2);
+       #elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+        return &Baseline::makeTable(Variant::NEON);
+       #else
+        return &Baseline::makeTable(Variant::Generic);
+       #endif
+    }
+}
@@ -0,0 +1,196 @@
+#include "DetectorLink.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+
+namespace
+{
+    // generation changes on every join and leave, so a publish from a member that has since
+    // left fails its check; publishers counts publishes past that check, and join skips a
+    // slot until they have finished
+    struct Slot
+    {
+        std::atomic<bool> used{ false };
+        std::atomic<std::uint32_t> generation{ 0 };
+        std::atomic<int> publishers{ 0 };
+        std::atomic<float> level{ 0.0f };
+        std::atomic<std::int64_t> timestamp{ 0 };
+    };
+
+    struct Group
+    {
+        char name[DetectorLink::maxNameLength + 1] = {};
+        int numMembers = 0;                 // guarded by the registry lock
+        std::atomic<int> slotsInUse{ 0 };   // one past the highest slot ever used
+        Slot slots[DetectorLink::maxMembersPerGroup];
+    };
+
+    // Static storage for the whole process; groups are recycled, never freed
+    struct Registry
+    {
+        std::mutex lock;
+        Group groups[DetectorLink::maxGroups];
+    };
+
+    Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    int indexOf(std::int64_t packed)
+    {
+        return static_cast<int>(packed & 0xffffffff);
+    }
+
+    std::uint32_t generationOf(std::int64_t packed)
+    {
+        return static_cast<std::uint32_t>(static_cast<std::uint64_t>(packed) >> 32);
+    }
+}
+
+//==============================================================================
+bool DetectorLink::join(const char* groupName)
+{
+    leave();
+
+    if (groupName == nullptr || groupName[0] == '\0')
+        return true;
+
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.lock);
+
+    Group* group = nullptr;
+    int groupIndex = -1;
+
+    for (int i = 0; i < maxGroups && group == nullptr; ++i)
+    {
+        if (registry.groups[i].numMembers > 0 && std::strncmp(registry.groups[i].name, groupName, maxNameLength) == 0)
+        {
+            group = &registry.groups[i];
+            groupIndex = i;
+        }
+    }
+
+    for (int i = 0; i < maxGroups && group == nullptr; ++i)
+    {
+        if (registry.groups[i].numMembers == 0)
+        {
+            group = &registry.groups[i];
+            groupIndex = i;
+            std::strncpy(group->name, groupName, maxNameLength);
+            group->name[maxNameLength] = '\0';
+        }
+    }
+
+    if (group == nullptr)
+        return false;
+
+    for (int slot = 0; slot < maxMembersPerGroup; ++slot)
+    {
+        // Free, and no former member's publish still writing into it
+        auto& s = group->slots[slot];
+        if (s.used.load(std::memory_order_relaxed) || s.publishers.load() != 0)
+            continue;
+
+        const std::uint32_t generation = s.generation.fetch_add(1) + 1;
+        s.level.store(0.0f, std::memory_order_relaxed);
+        s.timestamp.store(0, std::memory_order_relaxed);
+        s.used.store(true, std::memory_order_release);
+        ++group->numMembers;
+
+        if (slot >= group->slotsInUse.load(std::memory_order_relaxed))
+            group->slotsInUse.store(slot + 1, std::memory_order_release);
+
+        member.store(static_cast<std::int64_t>(static_cast<std::uint64_t>(generation) << 32)
+                         | (groupIndex * maxMembersPerGroup + slot),
+                     std::memory_order_release);
+        return true;
+    }
+
+    return false;
+}
+
+void DetectorLink::leave()
+{
+    const std::int64_t left = member.exchange(-1, std::memory_order_acq_rel);
+    if (left < 0)
+        return;
+
+    const int index = indexOf(left);
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.lock);
+
+    auto& group = registry.groups[index / maxMembersPerGroup];
+    auto& slot = group.slots[index % maxMembersPerGroup];
+
+    // Publishes that have not checked the generation yet now fail it; one already past the
+    // check keeps join off the slot until it is done, so it cannot reach a new member
+    slot.generation.fetch_add(1);
+    slot.used.store(false, std::memory_order_release);
+    slot.level.store(0.0f, std::memory_order_relaxed);
+
+    if (--group.numMembers == 0)
+    {
+        group.name[0] = '\0';
+        group.slotsInUse.store(0, std::memory_order_release);
+    }
+}
+
+void DetectorLink::publish(float level, std::int64_t timestamp)
+{
+    const std::int64_t joined = member.load(std::memory_order_acquire);
+    if (joined < 0)
+        return;
+
+    const int index = indexOf(joined);
+    auto& slot = getRegistry().groups[index / maxMembersPerGroup].slots[index % maxMembersPerGroup];
+
+    // Sequentially consistent with join's check and leave's increment: either join sees this
+    // publisher, or this publish sees the slot has changed hands
+    slot.publishers.fetch_add(1);
+
+    if (slot.generation.load() == generationOf(joined))
+    {
+        slot.level.store(level, std::memory_order_relaxed);
+        slot.timestamp.store(timestamp, std::memory_order_release);
+    }
+
+    slot.publishers.fetch_sub(1, std::memory_order_release);
+}
+
+float DetectorLink::readOthers(bool sum, std::int64_t timestamp) const
+{
+    const std::int64_t joined = member.load(std::memory_order_acquire);
+    if (joined < 0)
+        return 0.0f;
+
+    const int index = indexOf(joined);
+    const auto& group = getRegistry().groups[index / maxMembersPerGroup];
+    const int self = index % maxMembersPerGroup;
+    const int numSlots = group.slotsInUse.load(std::memory_order_acquire);
+    float result = 0.0f;
+
+    for (int i = 0; i < numSlots; ++i)
+    {
+        const auto& slot = group.slots[i];
+
+        if (i == self || !slot.used.load(std::memory_order_acquire))
+            continue;
+
+        if (timestamp - slot.timestamp.load(std::memory_order_acquire) > staleAfterNanoseconds)
+            continue;
+
+        const float level = slot.level.load(std::memory_order_relaxed);
+        result = sum ? result + level : std::max(result, level);
+    }
+
+    return result;
+}
+
+std::int64_t DetectorLink::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+//==============================================================================
+// Membership in a named, process-wide detector link group (VCA-group style linking
+// without sidechain routing). Each member publishes its detector level once per
+// sub-block and reads the max or sum of the other members' latest levels, which are
+// at most one host block old. Joining and leaving take a lock and belong on the
+// message thread; publish/readOthers are wait-free and allocation-free.
+class DetectorLink
+{
+public:
+    static constexpr int maxGroups = 32;
+    static constexpr int maxMembersPerGroup = 64;
+    static constexpr int maxNameLength = 31;
+
+    DetectorLink() = default;
+    ~DetectorLink() { leave(); }
+
+    DetectorLink(const DetectorLink&) = delete;
+    DetectorLink& operator=(const DetectorLink&) = delete;
+
+    // Null or empty leaves; returns false if the registry or the group is full
+    bool join(const char* groupName);
+    void leave();
+    bool isJoined() const { return member.load(std::memory_order_relaxed) >= 0; }
+
+    // Audio thread
+    void publish(float level, std::int64_t timestamp);
+    float readOthers(bool sum, std::int64_t timestamp) const;
+
+    // Common clock for timestamps (nanoseconds, monotonic)
+    static std::int64_t now();
+
+    // Members that have not published for this long are ignored (stopped or bypassed)
+    static constexpr std::int64_t staleAfterNanoseconds = 250000000;
+
+private:
+    // The slot's generation at join in the high 32 bits, group * maxMembersPerGroup + slot in
+    // the low ones; -1 when not joined
+    std::atomic<std::int64_t> member{ -1 };
+};
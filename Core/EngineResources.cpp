@@ -0,0 +1,82 @@
+#include "EngineResources.h"
+#include "Trace.h"
+
+#include <algorithm>
+
+//==============================================================================
+EngineResources::Key EngineResources::Key::fromParameters(const mixcomp_params& params, double sampleRate)
+{
+    Key key;
+    key.sampleRate = sampleRate;
+    key.scHPFHz = params.sc_hpf_hz;
+    key.scEQShape = std::clamp(params.sc_eq_shape, 0, 2);
+    key.scEQFreqHz = params.sc_eq_freq_hz;
+    key.scEQGainDB = params.sc_eq_gain_db;
+
+    if (params.adaptive_quality != 0)
+    {
+        // Same curve the stages derive from the parameters, so the tables match exactly
+        key.curveTables = true;
+        key.curve1 = stageCurve(params, 0);
+        key.curve2 = stageCurve(params, 1);
+    }
+
+    return key;
+}
+
+DSPKernels::CurveParams EngineResources::stageCurve(const mixcomp_params& params, int stageIndex)
+{
+    DSPKernels::CurveParams curve;
+    curve.kneeWidth = params.knee_db;
+
+    if (stageIndex == 0)
+    {
+        curve.thresholdDB = params.threshold1_db;
+        curve.ratio = std::max(1.0f, params.ratio1);
+
+        // Expander/gate and upward compression belong to the leveler; the upward segment
+        // never reaches into the compression range
+        curve.upwardThresholdDB = std::min(params.upward_threshold_db, params.threshold1_db);
+        curve.upwardRatio = std::max(1.0f, params.upward_ratio);
+        curve.expanderThresholdDB = params.expander_threshold_db;
+        curve.expanderRatio = std::max(1.0f, params.expander_ratio);
+        curve.expanderRangeDB = std::clamp(params.expander_range_db, 0.0f, DSPKernels::maxExpanderRangeDB);
+    }
+    else
+    {
+        curve.thresholdDB = params.threshold2_db;
+        curve.ratio = std::max(1.0f, params.ratio2);
+    }
+
+    return curve;
+}
+
+bool EngineResources::Key::operator==(const Key& other) const
+{
+    return sampleRate == other.sampleRate
+        && scHPFHz == other.scHPFHz
+        && scEQShape == other.scEQShape
+        && scEQFreqHz == other.scEQFreqHz
+        && scEQGainDB == other.scEQGainDB
+        && curveTables == other.curveTables
+        && curve1 == other.curve1
+        && curve2 == other.curve2;
+}
+
+void EngineResources::build(const Key& newKey)
+{
+    MIXCOMP_TRACE_SCOPE("buildResources", newKey.curveTables ? 1 : 0);
+
+    key = newKey;
+
+    // Side-chain detector EQ targets (tan/pow per section)
+    sidechain = SidechainFilterBank::design(key.sampleRate, key.scHPFHz,
+                                            static_cast<SidechainFilterBank::Shape>(key.scEQShape),
+                                            key.scEQFreqHz, key.scEQGainDB);
+
+    if (key.curveTables)
+    {
+        DSPKernels::buildGainCurveTable(curveTable1, key.curve1);
+        DSPKernels::buildGainCurveTable(curveTable2, key.curve2);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "include/mixcomp.h"
+#include "DSPKernels.h"
+#include "SidechainFilterBank.h"
+
+//==============================================================================
+// DSP resources derived from parameters that are too costly to rebuild on the audio
+// thread. An instance is built whole and never modified once the engine can see it:
+// the plugin's ResourceWorker builds them in the background and swaps them in by
+// pointer, while the C API builds them inline at the engine's parameter boundary.
+struct EngineResources
+{
+    // The settings a resource set is derived from; a rebuild is due when these move
+    struct Key
+    {
+        double sampleRate = 0.0;
+        float scHPFHz = -1.0f;
+        int scEQShape = 0;
+        float scEQFreqHz = -1.0f;
+        float scEQGainDB = 0.0f;
+
+        // Gain curve tables are only built while adaptive quality may need them
+        bool curveTables = false;
+        DSPKernels::CurveParams curve1, curve2;
+
+        static Key fromParameters(const mixcomp_params& params, double sampleRate);
+
+        bool operator==(const Key& other) const;
+        bool operator!=(const Key& other) const { return !(*this == other); }
+    };
+
+    Key key;
+    SidechainFilterBank::Design sidechain;
+    DSPKernels::GainCurveTable curveTable1, curveTable2;   // valid when key.curveTables
+
+    // The gain curve stage 0 (leveler) or 1 (peak catcher) runs for these parameters
+    static DSPKernels::CurveParams stageCurve(const mixcomp_params& params, int stageIndex);
+
+    // Allocation-free; any thread. Building the curve tables costs ~3000 log/exp2.
+    void build(const Key& newKey);
+};
@@ -0,0 +1,204 @@
+#include "EnvelopeScan.h"
+#include "ScopedFlushDenormals.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr int lanes = DSPKernels::numEnvelopeLanes;
+
+    // The kernels count samples in ints
+    constexpr std::int64_t maxKernelSamples = 1 << 24;
+
+    // Speculative chunks warm up over this many of the slower detector time constant (in
+    // samples, 1 / coefficient) before their start: a state that far off has decayed to
+    // under e^-8 of the gap even if the detector released all the way
+    constexpr float warmUpTimeConstants = 8.0f;
+    constexpr int warmUpPieceLength = 256;
+
+    struct Chunk
+    {
+        std::int64_t start = 0;
+        float speculativeEnd = 0.0f;    // end of the speculative pass (exact for the first chunk)
+        float walkedFrom = 0.0f;        // start state the stored envelope was corrected from
+        float end = 0.0f;               // end of the stored envelope
+    };
+
+    bool sameBits(float a, float b)
+    {
+        return std::memcmp(&a, &b, sizeof(float)) == 0;
+    }
+
+    float runKernel(const DSPKernels::KernelTable& kernels, const float* sc, float* env, std::int64_t numSamples,
+                    float state, float attackCoef, float releaseCoef)
+    {
+        for (std::int64_t start = 0; start < numSamples; start += maxKernelSamples)
+        {
+            const int length = static_cast<int>(std::min(maxKernelSamples, numSamples - start));
+            state = kernels.envelope(sc + start, env + start, length, state, attackCoef, releaseCoef);
+        }
+
+        return state;
+    }
+
+    // The envelope recurrence from a chunk's true start state, one sample at a time until it
+    // meets the stored envelope (a trajectory of the same recurrence ending at storedEnd)
+    float walk(const float* sc, float* env, std::int64_t numSamples, float state, float storedEnd,
+               float attackCoef, float releaseCoef)
+    {
+        for (std::int64_t i = 0; i < numSamples; ++i)
+        {
+            float detectorSignal = std::fabs(sc[i]);
+            float coef = detectorSignal > state ? attackCoef : releaseCoef;
+
+            state += (detectorSignal - state) * coef;
+            state = state < 0.0f ? 0.0f : (10.0f < state ? 10.0f : state);
+
+            if (sameBits(state, env[i]))
+                return storedEnd;
+
+            env[i] = state;
+        }
+
+        return state;
+    }
+
+    // function(t) for every t in [0, numThreads), the first on the calling thread
+    template <typename Function>
+    void runOnThreads(int numThreads, const Function& function)
+    {
+        std::vector<std::thread> workers;
+
+        for (int t = 1; t < numThreads; ++t)
+            workers.emplace_back([&function, t]
+            {
+                ScopedFlushDenormals noDenormals;
+                function(t);
+            });
+
+        function(0);
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+}
+
+//==============================================================================
+int EnvelopeScan::getUsefulThreads(std::int64_t numSamples, int numThreads)
+{
+    const int hardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    numThreads = numThreads <= 0 ? hardwareThreads : std::min(numThreads, hardwareThreads);
+
+    return static_cast<int>(std::min<std::int64_t>(numThreads, numSamples / (minChunkSamples * lanes)));
+}
+
+float EnvelopeScan::process(const DSPKernels::KernelTable& kernels, const float* sc, float* env, std::int64_t numSamples,
+                            float state, float attackCoef, float releaseCoef, int numThreads)
+{
+    ScopedFlushDenormals noDenormals;
+
+    if (numThreads <= 0)
+        numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    const int numGroups = static_cast<int>(std::min<std::int64_t>(numThreads, numSamples / (minChunkSamples * lanes)));
+    if (numGroups == 0)
+        return runKernel(kernels, sc, env, numSamples, state, attackCoef, releaseCoef);
+
+    const int numChunks = numGroups * lanes;
+    const std::int64_t chunkLength = numSamples / numChunks;
+    const std::int64_t warmUpLength = std::min(chunkLength, static_cast<std::int64_t>(std::ceil(
+                                          warmUpTimeConstants / std::max(1.0e-6f, std::min(attackCoef, releaseCoef)))));
+    std::vector<Chunk> chunks(static_cast<size_t>(numChunks));
+
+    for (int k = 0; k < numChunks; ++k)
+        chunks[k].start = k * chunkLength;
+
+    // Speculative pass: a group of chunks side by side per thread, all but the first from
+    // silence a warm-up ahead of their start
+    runOnThreads(numGroups, [&](int group)
+    {
+        const float* laneInputs[lanes];
+        float* laneOutputs[lanes];
+        float laneStates[lanes] = {};
+        float discard[lanes][warmUpPieceLength];
+
+        for (std::int64_t ahead = warmUpLength; ahead > 0; ahead -= warmUpPieceLength)
+        {
+            const int length = static_cast<int>(std::min<std::int64_t>(warmUpPieceLength, ahead));
+
+            // The first chunk has nothing ahead of it; its lane idles on the stream's start
+            for (int l = 0; l < lanes; ++l)
+            {
+                const auto& chunk = chunks[group * lanes + l];
+                laneInputs[l] = chunk.start >= ahead ? sc + chunk.start - ahead : sc;
+                laneOutputs[l] = discard[l];
+            }
+
+            kernels.envelopeLanes(laneInputs, laneOutputs, length, laneStates, attackCoef, releaseCoef);
+        }
+
+        for (int l = 0; l < lanes; ++l)
+        {
+            const auto& chunk = chunks[group * lanes + l];
+            laneInputs[l] = sc + chunk.start;
+            laneOutputs[l] = env + chunk.start;
+        }
+
+        if (group == 0)
+            laneStates[0] = state;
+
+        for (std::int64_t done = 0; done < chunkLength; done += maxKernelSamples)
+        {
+            const int length = static_cast<int>(std::min(maxKernelSamples, chunkLength - done));
+            kernels.envelopeLanes(laneInputs, laneOutputs, length, laneStates, attackCoef, releaseCoef);
+
+            for (int l = 0; l < lanes; ++l)
+            {
+                laneInputs[l] += length;
+                laneOutputs[l] += length;
+            }
+        }
+
+        for (int l = 0; l < lanes; ++l)
+            chunks[group * lanes + l].speculativeEnd = laneStates[l];
+    });
+
+    chunks[0].walkedFrom = state;
+    chunks[0].end = chunks[0].speculativeEnd;
+
+    // Corrections in parallel, each from where the previous chunk's speculative pass ended
+    runOnThreads(numGroups, [&](int thread)
+    {
+        for (int k = 1 + thread; k < numChunks; k += numGroups)
+        {
+            auto& chunk = chunks[k];
+            chunk.walkedFrom = chunks[k - 1].speculativeEnd;
+            chunk.end = walk(sc + chunk.start, env + chunk.start, chunkLength, chunk.walkedFrom, chunk.speculativeEnd,
+                             attackCoef, releaseCoef);
+        }
+    });
+
+    // Behind a chunk that never converged the next one started from the wrong state: walk it
+    // again from the true one
+    float carry = chunks[0].end;
+
+    for (int k = 1; k < numChunks; ++k)
+    {
+        auto& chunk = chunks[k];
+
+        if (!sameBits(chunk.walkedFrom, carry))
+        {
+            chunk.walkedFrom = carry;
+            chunk.end = walk(sc + chunk.start, env + chunk.start, chunkLength, carry, chunk.end, attackCoef, releaseCoef);
+        }
+
+        carry = chunk.end;
+    }
+
+    const std::int64_t tailStart = numChunks * chunkLength;
+    return runKernel(kernels, sc + tailStart, env + tailStart, numSamples - tailStart, carry, attackCoef, releaseCoef);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "DSPKernels.h"
+
+#include <cstdint>
+
+//==============================================================================
+// Peak envelope of a whole stream for offline renders, bit-identical to the envelope kernel
+// run over it in one go but without one long sample-by-sample dependency chain. The stream
+// is cut into numEnvelopeLanes chunks per thread, which run side by side in SIMD lanes
+// (envelopeLanes). Every chunk but the first starts speculatively from silence, warmed up
+// over the stretch ahead of it. The true state is then walked into each chunk serially only
+// until it reproduces the speculative value bit for bit; from there both trajectories are
+// the same recurrence on the same input. Walks run in parallel from the speculative chunk
+// ends and are redone in order when a chunk never converged.
+//
+// The warm-up spans eight of the slower time constant (at most a chunk), after which the
+// walks are usually a few samples. With time constants approaching the chunk length (slow
+// release on short streams or many threads) the warm-up is capped and the walks grow; at
+// worst a chunk costs two speculative passes and one serial one.
+namespace EnvelopeScan
+{
+    // Chunks are at least this long (fewer threads take part otherwise); a stream too short
+    // for one group of them runs the envelope kernel directly
+    constexpr std::int64_t minChunkSamples = 1 << 15;
+
+    // Threads worth giving process for a stream: numThreads (<= 0 for all) capped at the
+    // hardware threads and at one group of chunks each. Below two it does not pay off: a
+    // single group in SIMD lanes barely beats the kernel, and not by enough to cover a
+    // caller buffering the side-chain for it.
+    int getUsefulThreads(std::int64_t numSamples, int numThreads);
+
+    // Writes env[0, numSamples) and returns the final state, under ScopedFlushDenormals like
+    // the engine. numThreads <= 0 uses every hardware thread. Allocates; not for realtime use.
+    float process(const DSPKernels::KernelTable& kernels, const float* sc, float* env, std::int64_t numSamples,
+                  float state, float attackCoef, float releaseCoef, int numThreads);
+}
@@ -0,0 +1,161 @@
+#include "OutputLimiter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+
+namespace
+{
+    // Released gain this close to unity snaps to it (the one-pole would otherwise stall a
+    // float step below 1 and the limiter would never go idle)
+    constexpr float releaseSnapThreshold = 0.99999f;
+}
+
+//==============================================================================
+void OutputLimiter::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    lookahead = std::clamp(static_cast<int>(std::lround(lookaheadSeconds * sampleRate)), 1, maxLookaheadSamples);
+    lastReleaseMs = -1.0f;
+
+    reset();
+}
+
+void OutputLimiter::reset()
+{
+    dequeFront = dequeSize = 0;
+    sampleIndex = 0;
+
+    releasedGain = 1.0f;
+    std::fill(std::begin(averagedGains), std::end(averagedGains), 1.0f);
+    averagePos = 0;
+    averageSum = static_cast<double>(lookahead + 1);
+    attenuatedCount = 0;
+
+    for (auto& channelDelay : delayLine)
+        std::fill(std::begin(channelDelay), std::end(channelDelay), 0.0f);
+
+    delayPos = 0;
+}
+
+void OutputLimiter::setParameters(float ceilingDB, float releaseMs)
+{
+    ceiling = std::pow(10.0f, std::clamp(ceilingDB, -24.0f, 0.0f) * 0.05f);
+
+    if (releaseMs != lastReleaseMs)
+    {
+        releaseCoef = std::exp(-1.0f / (std::max(0.1f, releaseMs) * 0.001f * static_cast<float>(sampleRate)));
+        lastReleaseMs = releaseMs;
+    }
+}
+
+float OutputLimiter::nextGain(float peak)
+{
+    const int windowLength = lookahead + 1;
+
+    // Sliding-window maximum over the samples above the ceiling: a quieter sample behind a
+    // louder, newer one can never be the maximum again
+    if (peak > ceiling)
+    {
+        while (dequeSize > 0 && dequePeak[(dequeFront + dequeSize - 1) & (dequeCapacity - 1)] <= peak)
+            --dequeSize;
+
+        const int back = (dequeFront + dequeSize) & (dequeCapacity - 1);
+        dequeIndex[back] = sampleIndex;
+        dequePeak[back] = peak;
+        ++dequeSize;
+    }
+
+    while (dequeSize > 0 && dequeIndex[dequeFront] <= sampleIndex - windowLength)
+    {
+        dequeFront = (dequeFront + 1) & (dequeCapacity - 1);
+        --dequeSize;
+    }
+
+    ++sampleIndex;
+
+    const float target = dequeSize > 0 ? std::min(1.0f, ceiling / dequePeak[dequeFront]) : 1.0f;
+
+    // Instant attack, exponential release
+    releasedGain = 1.0f - (1.0f - releasedGain) * releaseCoef;
+    if (releasedGain > releaseSnapThreshold)
+        releasedGain = 1.0f;
+
+    releasedGain = std::min(releasedGain, target);
+
+    // Every gain averaged here was computed while the peak now leaving the delay line was
+    // inside the window, so the average is at or below what that peak needs
+    const float oldest = averagedGains[averagePos];
+    averagedGains[averagePos] = releasedGain;
+    averagePos = averagePos + 1 == windowLength ? 0 : averagePos + 1;
+
+    attenuatedCount += (releasedGain < 1.0f ? 1 : 0) - (oldest < 1.0f ? 1 : 0);
+    averageSum += static_cast<double>(releasedGain) - static_cast<double>(oldest);
+
+    if (attenuatedCount == 0)
+    {
+        averageSum = static_cast<double>(windowLength);
+        return 1.0f;
+    }
+
+    return static_cast<float>(averageSum / windowLength);
+}
+
+void OutputLimiter::process(float* const* channels, int numChannels, int numSamples)
+{
+    assert(numChannels <= maxChannels);
+
+    // Idle and nothing in this block reaches the ceiling: only the delay runs
+    if (isIdle())
+    {
+        float blockPeak = 0.0f;
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                blockPeak = std::max(blockPeak, std::fabs(channels[channel][i]));
+
+        if (blockPeak <= ceiling)
+        {
+            int pos = delayPos;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* samples = channels[channel];
+                auto* delay = delayLine[channel];
+                pos = delayPos;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float delayed = delay[pos];
+                    delay[pos] = samples[i];
+                    samples[i] = delayed;
+                    pos = pos + 1 == lookahead ? 0 : pos + 1;
+                }
+            }
+
+            delayPos = pos;
+            sampleIndex += numSamples;
+            averagePos = (averagePos + numSamples) % (lookahead + 1);
+            return;
+        }
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float peak = 0.0f;
+        for (int channel = 0; channel < numChannels; ++channel)
+            peak = std::max(peak, std::fabs(channels[channel][i]));
+
+        const float gain = nextGain(peak);
+
+        // The clamp only catches float rounding in the average; the gain already holds the ceiling
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float delayed = delayLine[channel][delayPos];
+            delayLine[channel][delayPos] = channels[channel][i];
+            channels[channel][i] = std::clamp(delayed * gain, -ceiling, ceiling);
+        }
+
+        delayPos = delayPos + 1 == lookahead ? 0 : delayPos + 1;
+    }
+}
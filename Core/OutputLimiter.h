@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+//==============================================================================
+// Look-ahead brickwall limiter for the output, linked across channels. The gain for each
+// sample is the ceiling over the loudest sample within the look-ahead window (a monotonic
+// deque, amortised O(1) per sample), released exponentially and then averaged over the
+// window, so it has fully ramped down by the time the peak leaves the delay line. Output
+// is delayed by getLatencySamples(); while nothing reaches the ceiling and the release has
+// settled, samples come out delayed but bit-identical.
+class OutputLimiter
+{
+public:
+    static constexpr int maxChannels = 8;
+    static constexpr int maxLookaheadSamples = 1023;
+    static constexpr double lookaheadSeconds = 0.0015;
+
+    // Sets the look-ahead for the rate and clears all state
+    void prepare(double sampleRate);
+    void reset();
+
+    void setParameters(float ceilingDB, float releaseMs);
+
+    int getLatencySamples() const { return lookahead; }
+
+    // In place; every channel goes through the same gain
+    void process(float* const* channels, int numChannels, int numSamples);
+
+private:
+    // Window and averaging span: the current input plus the look-ahead behind it
+    static constexpr int windowCapacity = maxLookaheadSamples + 1;
+    static constexpr int dequeCapacity = 1024;
+    static_assert((dequeCapacity & (dequeCapacity - 1)) == 0 && dequeCapacity >= windowCapacity,
+                  "the deque is a power-of-two ring covering a whole window");
+
+    double sampleRate = 44100.0;
+    int lookahead = 1;
+    float ceiling = 1.0f;
+    float releaseCoef = 0.0f;
+    float lastReleaseMs = -1.0f;
+
+    // Samples above the ceiling still inside the window, in decreasing peak order
+    std::int64_t dequeIndex[dequeCapacity] = {};
+    float dequePeak[dequeCapacity] = {};
+    int dequeFront = 0, dequeSize = 0;
+    std::int64_t sampleIndex = 0;
+
+    // Released gain and its moving average (attenuatedCount of the averaged gains are below 1;
+    // at zero the sum is snapped back to exactly the window length)
+    float releasedGain = 1.0f;
+    float averagedGains[windowCapacity] = {};
+    int averagePos = 0;
+    double averageSum = 0.0;
+    int attenuatedCount = 0;
+
+    float delayLine[maxChannels][maxLookaheadSamples] = {};
+    int delayPos = 0;
+
+    bool isIdle() const { return dequeSize == 0 && releasedGain == 1.0f && attenuatedCount == 0; }
+    float nextGain(float peak);
+};
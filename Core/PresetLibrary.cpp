@@ -0,0 +1,374 @@
+#include "PresetLibrary.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(_WIN32)
+ #define WIN32_LEAN_AND_MEAN
+ #define NOMINMAX
+ #include <windows.h>
+#else
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    // Largest parameter record accepted; far more than mixcomp_params will ever grow to
+    constexpr std::uint32_t maxParamsSize = 4096;
+
+    char toLower(char c)
+    {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool equalsIgnoringCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+
+        for (size_t i = 0; i < a.size(); ++i)
+            if (toLower(a[i]) != toLower(b[i]))
+                return false;
+
+        return true;
+    }
+
+    bool lessIgnoringCase(std::string_view a, std::string_view b)
+    {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(),
+                                            [](char x, char y) { return toLower(x) < toLower(y); });
+    }
+
+    // needle is already lower case
+    bool containsIgnoringCase(std::string_view haystack, std::string_view needle)
+    {
+        if (needle.size() > haystack.size())
+            return false;
+
+        for (size_t start = 0; start + needle.size() <= haystack.size(); ++start)
+        {
+            size_t i = 0;
+            while (i < needle.size() && toLower(haystack[start + i]) == needle[i])
+                ++i;
+
+            if (i == needle.size())
+                return true;
+        }
+
+        return false;
+    }
+
+    std::string_view boundedString(const char* text, size_t capacity)
+    {
+        return std::string_view(text, static_cast<size_t>(std::find(text, text + capacity, '\0') - text));
+    }
+
+    // Modification time, size and file number, to tell a replaced file from the one mapped
+    bool identify(const std::string& path, std::int64_t& modificationTime, std::uint64_t& fileSize, std::uint64_t& fileNumber)
+    {
+#if defined(_WIN32)
+        struct _stat64 info;
+        if (_stat64(path.c_str(), &info) != 0)
+            return false;
+#else
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0)
+            return false;
+#endif
+
+        modificationTime = static_cast<std::int64_t>(info.st_mtime);
+        fileSize = static_cast<std::uint64_t>(info.st_size);
+        fileNumber = static_cast<std::uint64_t>(info.st_ino);
+        return true;
+    }
+
+    struct Cache
+    {
+        std::mutex lock;
+        std::map<std::string, std::weak_ptr<const PresetLibrary>> libraries;
+    };
+
+    Cache& getCache()
+    {
+        static Cache cache;
+        return cache;
+    }
+}
+
+//==============================================================================
+std::shared_ptr<const PresetLibrary> PresetLibrary::open(const std::string& path, std::string& error)
+{
+    std::int64_t modificationTime = 0;
+    std::uint64_t fileSize = 0, fileNumber = 0;
+
+    if (!identify(path, modificationTime, fileSize, fileNumber))
+    {
+        error = "cannot open " + path;
+        return nullptr;
+    }
+
+    auto& cache = getCache();
+    const std::lock_guard<std::mutex> guard(cache.lock);
+
+    if (auto shared = cache.libraries[path].lock())
+        if (shared->modificationTime == modificationTime && shared->fileSize == fileSize && shared->fileNumber == fileNumber)
+            return shared;
+
+    std::shared_ptr<PresetLibrary> library(new PresetLibrary());
+    library->modificationTime = modificationTime;
+    library->fileSize = fileSize;
+    library->fileNumber = fileNumber;
+    void* address = nullptr;
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER length = {};
+
+    if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &length) && length.QuadPart >= static_cast<LONGLONG>(sizeof(Header)))
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping != nullptr)
+        {
+            address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+            if (address != nullptr)
+            {
+                library->handle = mapping;
+                library->size = static_cast<std::uint64_t>(length.QuadPart);
+            }
+            else
+                CloseHandle(mapping);
+        }
+    }
+
+    if (file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd >= 0)
+    {
+        struct stat info;
+
+        if (fstat(fd, &info) == 0 && static_cast<std::uint64_t>(info.st_size) >= sizeof(Header))
+        {
+            address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+
+            if (address == MAP_FAILED)
+                address = nullptr;
+            else
+                library->size = static_cast<std::uint64_t>(info.st_size);
+        }
+
+        ::close(fd);
+    }
+#endif
+
+    if (address == nullptr)
+    {
+        error = "cannot map " + path;
+        return nullptr;
+    }
+
+    library->data = static_cast<const unsigned char*>(address);
+    library->header = reinterpret_cast<const Header*>(library->data);
+
+    // Section bounds only; the entries are read on demand
+    const auto& header = *library->header;
+    const std::uint64_t tagsEnd = sizeof(Header) + std::uint64_t(header.numTags) * sizeof(TagName);
+    const std::uint64_t indexEnd = header.indexOffset + std::uint64_t(header.numEntries) * sizeof(IndexRecord);
+    const std::uint64_t paramsEnd = header.paramsOffset + std::uint64_t(header.numEntries) * header.paramsSize;
+
+    const bool valid = header.magic == fileMagic && header.version == formatVersion
+        && header.numTags <= static_cast<std::uint32_t>(maxTags) && header.numEntries <= 0x7fffffffu
+        && header.paramsSize > 0 && header.paramsSize <= maxParamsSize
+        && header.indexOffset <= library->size && header.paramsOffset <= library->size
+        && header.indexOffset % alignof(IndexRecord) == 0 && header.indexOffset >= tagsEnd
+        && header.paramsOffset >= indexEnd && indexEnd <= library->size && paramsEnd <= library->size;
+
+    if (!valid)
+    {
+        error = path + " is not a preset library of this version";
+        return nullptr;
+    }
+
+    library->tagNames = reinterpret_cast<const TagName*>(library->data + sizeof(Header));
+    library->index = reinterpret_cast<const IndexRecord*>(library->data + header.indexOffset);
+    library->params = library->data + header.paramsOffset;
+
+    cache.libraries[path] = library;
+    return library;
+}
+
+PresetLibrary::~PresetLibrary()
+{
+    if (data == nullptr)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(data);
+    CloseHandle(static_cast<HANDLE>(handle));
+#else
+    munmap(const_cast<unsigned char*>(data), static_cast<size_t>(size));
+#endif
+}
+
+//==============================================================================
+std::string_view PresetLibrary::getTagName(int tag) const
+{
+    return boundedString(tagNames[tag].text, sizeof(TagName::text));
+}
+
+int PresetLibrary::findTag(std::string_view name) const
+{
+    for (int tag = 0; tag < getNumTags(); ++tag)
+        if (equalsIgnoringCase(getTagName(tag), name))
+            return tag;
+
+    return -1;
+}
+
+std::string_view PresetLibrary::getName(int entry) const
+{
+    return boundedString(index[entry].name, sizeof(IndexRecord::name));
+}
+
+bool PresetLibrary::getParams(int entry, mixcomp_params& result) const
+{
+    if (entry < 0 || entry >= getNumEntries())
+        return false;
+
+    mixcomp_default_params(&result);
+    std::memcpy(&result, params + std::uint64_t(entry) * header->paramsSize,
+                std::min<size_t>(sizeof(mixcomp_params), header->paramsSize));
+    return true;
+}
+
+void PresetLibrary::search(const Query& query, std::vector<int>& matches) const
+{
+    std::string needle(query.nameContains);
+    std::transform(needle.begin(), needle.end(), needle.begin(), toLower);
+
+    matches.clear();
+
+    for (int entry = 0; entry < getNumEntries(); ++entry)
+    {
+        const auto& record = index[entry];
+
+        if ((record.tags & query.requiredTags) == query.requiredTags
+            && (query.topology < 0 || record.topology == query.topology)
+            && containsIgnoringCase(boundedString(record.name, sizeof(record.name)), needle))
+            matches.push_back(entry);
+    }
+}
+
+//==============================================================================
+bool PresetLibrary::write(const std::string& path, std::vector<Entry> entries, std::string& error)
+{
+    if (entries.size() > 0x7fffffffu)
+    {
+        error = "too many presets";
+        return false;
+    }
+
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Entry& a, const Entry& b) { return lessIgnoringCase(a.name, b.name); });
+
+    std::vector<TagName> tagNames;
+    std::vector<IndexRecord> records(entries.size());
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const auto& entry = entries[i];
+        auto& record = records[i];
+
+        if (entry.name.empty() || entry.name.size() > static_cast<size_t>(maxNameLength))
+        {
+            error = "preset name '" + entry.name + "' must be 1 to " + std::to_string(maxNameLength) + " characters";
+            return false;
+        }
+
+        std::memset(&record, 0, sizeof(record));
+        std::memcpy(record.name, entry.name.data(), entry.name.size());
+        record.topology = entry.params.topology;
+
+        for (const auto& tag : entry.tags)
+        {
+            auto found = std::find_if(tagNames.begin(), tagNames.end(),
+                                      [&tag](const TagName& t) { return equalsIgnoringCase(boundedString(t.text, sizeof(t.text)), tag); });
+
+            if (found == tagNames.end())
+            {
+                if (tag.empty() || tag.size() > static_cast<size_t>(maxTagLength) || tagNames.size() == static_cast<size_t>(maxTags))
+                {
+                    error = "tag '" + tag + "' must be 1 to " + std::to_string(maxTagLength)
+                          + " characters, with at most " + std::to_string(maxTags) + " tags per library";
+                    return false;
+                }
+
+                TagName name = {};
+                std::memcpy(name.text, tag.data(), tag.size());
+                found = tagNames.insert(tagNames.end(), name);
+            }
+
+            record.tags |= std::uint64_t(1) << (found - tagNames.begin());
+        }
+    }
+
+    Header header = {};
+    header.magic = fileMagic;
+    header.version = formatVersion;
+    header.numEntries = static_cast<std::uint32_t>(entries.size());
+    header.numTags = static_cast<std::uint32_t>(tagNames.size());
+    header.paramsSize = sizeof(mixcomp_params);
+    header.indexOffset = sizeof(Header) + tagNames.size() * sizeof(TagName);
+    header.indexOffset += (alignof(IndexRecord) - header.indexOffset % alignof(IndexRecord)) % alignof(IndexRecord);
+    header.paramsOffset = header.indexOffset + records.size() * sizeof(IndexRecord);
+
+    const std::string temporaryPath = path + ".tmp";
+    std::FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+
+    if (file == nullptr)
+    {
+        error = "cannot create " + temporaryPath;
+        return false;
+    }
+
+    const char padding[alignof(IndexRecord)] = {};
+    const size_t paddingSize = static_cast<size_t>(header.indexOffset - sizeof(Header) - tagNames.size() * sizeof(TagName));
+
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+        && std::fwrite(tagNames.data(), sizeof(TagName), tagNames.size(), file) == tagNames.size()
+        && std::fwrite(padding, 1, paddingSize, file) == paddingSize
+        && std::fwrite(records.data(), sizeof(IndexRecord), records.size(), file) == records.size();
+
+    for (size_t i = 0; written && i < entries.size(); ++i)
+        written = std::fwrite(&entries[i].params, sizeof(mixcomp_params), 1, file) == 1;
+
+    written = std::fclose(file) == 0 && written;
+
+#if defined(_WIN32)
+    written = written && MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    written = written && std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+#endif
+
+    if (!written)
+    {
+        std::remove(temporaryPath.c_str());
+        error = "cannot write " + path;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "mixcomp.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//==============================================================================
+// Read-only preset library: one indexed binary file holding any number of presets, mapped
+// into memory and shared by every user in the process (the OS shares the pages between
+// processes). The index is an array of fixed-size records sorted by name, each with the
+// entry's tags as bits and its topology, which search scans in place; an entry's parameters
+// are only read when it is loaded. Opening checks the header and the section sizes, never
+// the entries, so it costs the same for any library size. Built by tools/mixcomp_presets.
+class PresetLibrary
+{
+public:
+    static constexpr std::uint32_t fileMagic = 0x4c50434d;     // "MCPL"
+    static constexpr std::uint32_t formatVersion = 1;
+    static constexpr int maxNameLength = 47;
+    static constexpr int maxTags = 64;
+    static constexpr int maxTagLength = 23;
+
+    // File layout (little-endian): Header, numTags TagNames, numEntries IndexRecords, then
+    // numEntries parameter records of paramsSize bytes each in index order. A parameter
+    // record is the mixcomp_params of the version that wrote it; fields appended since then
+    // read as their defaults. Names and tags are NUL-padded and need no terminator.
+    struct Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t numEntries;
+        std::uint32_t numTags;
+        std::uint32_t paramsSize;
+        std::uint32_t reserved;
+        std::uint64_t indexOffset;
+        std::uint64_t paramsOffset;
+    };
+
+    struct TagName
+    {
+        char text[maxTagLength + 1];
+    };
+
+    struct IndexRecord
+    {
+        char name[maxNameLength + 1];
+        std::uint64_t tags;             // bit t set for tag t
+        std::int32_t topology;          // mixcomp_topology
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(Header) == 40 && sizeof(TagName) == 24 && sizeof(IndexRecord) == 64, "fixed file layout");
+
+    // The process-wide mapping of path, shared while anyone holds it and mapped afresh once
+    // the file has changed; nullptr with error set when it is missing or malformed
+    static std::shared_ptr<const PresetLibrary> open(const std::string& path, std::string& error);
+
+    ~PresetLibrary();
+
+    PresetLibrary(const PresetLibrary&) = delete;
+    PresetLibrary& operator=(const PresetLibrary&) = delete;
+
+    int getNumEntries() const { return static_cast<int>(header->numEntries); }
+    int getNumTags() const { return static_cast<int>(header->numTags); }
+
+    std::string_view getTagName(int tag) const;
+    int findTag(std::string_view name) const;      // case-insensitive; -1 if unknown
+
+    std::string_view getName(int entry) const;
+    std::uint64_t getTags(int entry) const { return index[entry].tags; }
+    int getTopology(int entry) const { return index[entry].topology; }
+
+    // Defaults overlaid with the stored record; false for an index out of range
+    bool getParams(int entry, mixcomp_params& params) const;
+
+    struct Query
+    {
+        std::string_view nameContains;      // case-insensitive; empty matches any name
+        std::uint64_t requiredTags = 0;     // every one of these bits
+        int topology = -1;                  // -1 for any
+    };
+
+    // Replaces matches with the matching entries in index (name) order
+    void search(const Query& query, std::vector<int>& matches) const;
+
+    //==============================================================================
+    struct Entry
+    {
+        std::string name;
+        std::vector<std::string> tags;
+        mixcomp_params params;
+    };
+
+    // Writes a library sorted by name (case-insensitive). Goes through a temporary file and
+    // a rename, so instances mapping the old file keep reading it until they reopen (Windows
+    // refuses the rename while any process has the old file mapped).
+    static bool write(const std::string& path, std::vector<Entry> entries, std::string& error);
+
+private:
+    PresetLibrary() = default;
+
+    const unsigned char* data = nullptr;
+    std::uint64_t size = 0;
+    void* handle = nullptr;
+
+    const Header* header = nullptr;
+    const TagName* tagNames = nullptr;
+    const IndexRecord* index = nullptr;
+    const unsigned char* params = nullptr;
+
+    // Identifies the file mapped, to tell when it has been replaced
+    std::int64_t modificationTime = 0;
+    std::uint64_t fileSize = 0;
+    std::uint64_t fileNumber = 0;
+};
@@ -0,0 +1,61 @@
+#include "QualityGovernor.h"
+
+#include <algorithm>
+
+//==============================================================================
+void QualityGovernor::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void QualityGovernor::reset()
+{
+    tier = Full;
+    load = 0.0f;
+    overBudgetCalls = 0;
+    headroomSeconds = 0.0;
+}
+
+int QualityGovernor::update(double elapsedSeconds, int numSamples, float budgetFraction)
+{
+    if (numSamples <= 0)
+        return tier;
+
+    const double deadlineSeconds = numSamples / sampleRate;
+    const float callLoad = static_cast<float>(elapsedSeconds / deadlineSeconds);
+    load += (callLoad - load) * loadSmoothing;
+
+    // A single preempted call should not cost quality: require consecutive overruns
+    if (callLoad > budgetFraction && load > budgetFraction)
+    {
+        headroomSeconds = 0.0;
+
+        if (++overBudgetCalls >= overrunsBeforeStepDown && tier < NumTiers - 1)
+        {
+            ++tier;
+            overBudgetCalls = 0;
+        }
+
+        return tier;
+    }
+
+    overBudgetCalls = 0;
+
+    if (load < budgetFraction * stepUpLoadRatio)
+    {
+        headroomSeconds += deadlineSeconds;
+
+        if (headroomSeconds >= headroomSecondsBeforeStepUp && tier > Full)
+        {
+            --tier;
+            headroomSeconds = 0.0;
+        }
+    }
+    else
+    {
+        headroomSeconds = 0.0;
+    }
+
+    return tier;
+}
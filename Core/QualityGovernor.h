@@ -0,0 +1,42 @@
+#pragma once
+
+//==============================================================================
+// Adaptive quality: compares each process() call's wall time with its real-time deadline
+// and steps the engine through cheaper tiers when the instance overruns its share of the
+// budget, then back up once there has been ample headroom for a while.
+class QualityGovernor
+{
+public:
+    enum Tier
+    {
+        Full = 0,       // exact log/pow gain curve, detector rate as configured
+        LookupCurve,    // gain curve from a table
+        ControlRate,    // table, and the detectors forced to at least controlRateFloor
+        NumTiers
+    };
+
+    static constexpr int controlRateFloor = 8;
+
+    void prepare(double sampleRate);
+    void reset();
+
+    // Feed one measurement; returns the tier to use from the next sub-block on.
+    // budgetFraction is this instance's share of the deadline (0.1 = 10%).
+    int update(double elapsedSeconds, int numSamples, float budgetFraction);
+
+    int getTier() const { return tier; }
+    float getLoad() const { return load; }   // smoothed elapsed / deadline
+
+private:
+    double sampleRate = 44100.0;
+    int tier = Full;
+    float load = 0.0f;
+    int overBudgetCalls = 0;
+    double headroomSeconds = 0.0;
+
+    // Down quickly (a few consecutive overruns), up slowly (seconds of comfortable headroom)
+    static constexpr int overrunsBeforeStepDown = 3;
+    static constexpr double headroomSecondsBeforeStepUp = 2.0;
+    static constexpr float stepUpLoadRatio = 0.5f;   // hysteresis band below the budget
+    static constexpr float loadSmoothing = 0.2f;
+};
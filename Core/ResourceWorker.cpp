@@ -0,0 +1,93 @@
+#include "ResourceWorker.h"
+
+#include <chrono>
+#include <memory>
+
+//==============================================================================
+ResourceWorker::ResourceWorker(CompressorEngine& engineToFeed, std::function<bool(mixcomp_params&)> parameterReader)
+    : engine(engineToFeed), readParameters(std::move(parameterReader))
+{
+}
+
+ResourceWorker::~ResourceWorker()
+{
+    stop();
+}
+
+void ResourceWorker::start(double newSampleRate)
+{
+    stop();
+
+    sampleRate = newSampleRate;
+    shouldExit = false;
+    reportedKey = {};
+    changed.store(false, std::memory_order_relaxed);
+    thread = std::thread([this] { run(); });
+}
+
+void ResourceWorker::stop()
+{
+    if (!thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shouldExit = true;
+    }
+
+    wake.notify_one();
+    thread.join();
+
+    // Anything retired after the last pass
+    engine.collectRetiredResources();
+}
+
+void ResourceWorker::checkParameters(const mixcomp_params& params)
+{
+    const auto key = EngineResources::Key::fromParameters(params, sampleRate);
+    if (key == reportedKey)
+        return;
+
+    reportedKey = key;
+    changed.store(true, std::memory_order_release);
+}
+
+void ResourceWorker::run()
+{
+    // Always publish once: parameters may have moved since prepare() built the inline set
+    EngineResources::Key published;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (!shouldExit)
+    {
+        lock.unlock();
+
+        engine.collectRetiredResources();
+
+        mixcomp_params params;
+        const bool consistent = readParameters(params);
+
+        if (consistent)
+        {
+            const auto key = EngineResources::Key::fromParameters(params, sampleRate);
+
+            if (key != published)
+            {
+                auto fresh = std::make_unique<EngineResources>();
+                fresh->build(key);
+                engine.publishResources(std::move(fresh));
+                published = key;
+            }
+        }
+
+        // Poll for the audio thread's flag; only stop() notifies
+        const auto deadline = std::chrono::steady_clock::now()
+                            + std::chrono::milliseconds(consistent ? idleTimeoutMs : retryIntervalMs);
+        lock.lock();
+
+        while (!shouldExit && !changed.exchange(false, std::memory_order_acq_rel)
+               && std::chrono::steady_clock::now() < deadline)
+            wake.wait_for(lock, std::chrono::milliseconds(pollIntervalMs));
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CompressorEngine.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+//==============================================================================
+// Background preparation thread for one engine. Polls a flag the audio thread raises when
+// parameters need different resources (every few milliseconds, sleeping in between), builds a fresh EngineResources for its
+// key and publishes it to the engine, which swaps it in at its next sub-block boundary
+// without locking. Resources the engine has retired are deleted here, so the audio
+// thread never allocates or frees them.
+class ResourceWorker
+{
+public:
+    // readParameters is called on the worker thread and must be safe there; returning false
+    // (parameters mid-update) makes the worker try again shortly
+    ResourceWorker(CompressorEngine& engine, std::function<bool(mixcomp_params&)> readParameters);
+    ~ResourceWorker();
+
+    // (Re)starts the thread for a sample rate; call after engine.prepare()
+    void start(double sampleRate);
+    void stop();
+
+    // Audio thread, with the parameters just handed to the engine: flags a change for the
+    // worker when their resource key differs from the last one reported. Lock-, allocation-
+    // and syscall-free: one atomic store, no notify; the worker picks it up at its next poll.
+    void checkParameters(const mixcomp_params& params);
+
+private:
+    CompressorEngine& engine;
+    std::function<bool(mixcomp_params&)> readParameters;
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool shouldExit = false;
+    double sampleRate = 0.0;
+
+    std::atomic<bool> changed{ false };
+    EngineResources::Key reportedKey;   // audio thread
+
+    // The worker checks the flag every pollIntervalMs; the condition variable only cuts the
+    // wait short for stop(). Retired sets are collected at least every idleTimeoutMs.
+    static constexpr int pollIntervalMs = 5;
+    static constexpr int idleTimeoutMs = 1000;
+    static constexpr int retryIntervalMs = 2;
+
+    void run();
+};
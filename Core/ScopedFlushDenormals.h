@@ -0,0 +1,27 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #include <xmmintrin.h>
+#endif
+
+//==============================================================================
+// Flush-to-zero / denormals-are-zero for the duration of a process call
+// (same flags juce::ScopedNoDenormals sets). Everything that has to match the engine's
+// output bit for bit runs under it.
+struct ScopedFlushDenormals
+{
+   #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    ScopedFlushDenormals() : saved(_mm_getcsr())   { _mm_setcsr(saved | 0x8040); }
+    ~ScopedFlushDenormals()                         { _mm_setcsr(saved); }
+    unsigned int saved;
+   #elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+    ScopedFlushDenormals()
+    {
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(saved));
+        unsigned long long flushed = saved | (1ull << 24);
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(flushed));
+    }
+    ~ScopedFlushDenormals()                         { __asm__ __volatile__("msr fpcr, %0" : : "r"(saved)); }
+    unsigned long long saved;
+   #endif
+};
@@ -0,0 +1,212 @@
+#include "SidechainFilterBank.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+//==============================================================================
+void SidechainFilterBank::Section::setTarget(const Coefficients& newTarget, bool snap)
+{
+    target = newTarget;
+
+    if (snap)
+    {
+        current = target;
+        rampRemaining = 0;
+    }
+    else
+    {
+        const float scale = 1.0f / rampLengthSamples;
+        step.g = (target.g - current.g) * scale;
+        step.k = (target.k - current.k) * scale;
+        step.m0 = (target.m0 - current.m0) * scale;
+        step.m1 = (target.m1 - current.m1) * scale;
+        step.m2 = (target.m2 - current.m2) * scale;
+        rampRemaining = rampLengthSamples;
+    }
+
+    updateDerived();
+}
+
+void SidechainFilterBank::Section::updateDerived()
+{
+    a1 = 1.0f / (1.0f + current.g * (current.g + current.k));
+    a2 = current.g * a1;
+    a3 = current.g * a2;
+}
+
+void SidechainFilterBank::Section::reset()
+{
+    ic1eq = {};
+    ic2eq = {};
+}
+
+bool SidechainFilterBank::Section::isBypassed() const
+{
+    return rampRemaining == 0 && current.m0 == 1.0f && current.m1 == 0.0f && current.m2 == 0.0f;
+}
+
+void SidechainFilterBank::Section::advanceRamp()
+{
+    // Glide: linear steps on g/k/m, only the cheap a1..a3 are rederived per sample
+    if (rampRemaining == 0)
+        return;
+
+    if (--rampRemaining == 0)
+    {
+        current = target;
+    }
+    else
+    {
+        current.g += step.g;
+        current.k += step.k;
+        current.m0 += step.m0;
+        current.m1 += step.m1;
+        current.m2 += step.m2;
+    }
+
+    updateDerived();
+}
+
+void SidechainFilterBank::Section::processSample(Lanes& x)
+{
+    advanceRamp();
+
+    const float c1 = a1, c2 = a2, c3 = a3;
+    const float m0 = current.m0, m1 = current.m1, m2 = current.m2;
+
+    for (int lane = 0; lane < maxChannels; ++lane)
+    {
+        float v0 = x.v[lane];
+        float v3 = v0 - ic2eq.v[lane];
+        float v1 = ic1eq.v[lane] * c1 + v3 * c2;
+        float v2 = ic2eq.v[lane] + ic1eq.v[lane] * c2 + v3 * c3;
+        ic1eq.v[lane] = v1 * 2.0f - ic1eq.v[lane];
+        ic2eq.v[lane] = v2 * 2.0f - ic2eq.v[lane];
+
+        x.v[lane] = v0 * m0 + v1 * m1 + v2 * m2;
+    }
+}
+
+//==============================================================================
+void SidechainFilterBank::prepare()
+{
+    // The next design snaps instead of gliding
+    prepared = false;
+    hpfCutoff = -1.0f;
+    shapeFrequency = -1.0f;
+    reset();
+}
+
+void SidechainFilterBank::reset()
+{
+    highPass.reset();
+    shaping.reset();
+}
+
+float SidechainFilterBank::prewarp(double sr, float frequencyHz)
+{
+    const float pi = 3.14159265358979323846f;
+    auto nyquistSafe = std::min(frequencyHz, static_cast<float>(sr) * 0.45f);
+    return std::tan(pi * nyquistSafe / static_cast<float>(sr));
+}
+
+SidechainFilterBank::Design SidechainFilterBank::design(double sr, float highPassHz, Shape shape, float frequencyHz, float gainDB)
+{
+    Design d;
+    d.highPassHz = highPassHz;
+    d.shape = shape;
+    d.shapeFrequencyHz = frequencyHz;
+    d.shapeGainDB = gainDB;
+
+    d.highPass.g = prewarp(sr, highPassHz);
+    d.highPass.k = butterworthDamping;
+    d.highPass.m0 = 1.0f;
+    d.highPass.m1 = -butterworthDamping;
+    d.highPass.m2 = -1.0f;
+
+    auto& c = d.shaping;
+    const float A = std::pow(10.0f, gainDB / 40.0f);
+
+    switch (shape)
+    {
+    case Shape::Tilt:
+        // High shelf of the full gain, scaled down by half of it
+        c.g = prewarp(sr, frequencyHz) * std::sqrt(A);
+        c.k = tiltDamping;
+        c.m0 = A;
+        c.m1 = tiltDamping * (1.0f - A);
+        c.m2 = (1.0f - A * A) / A;
+        break;
+
+    case Shape::Bell:
+        c.g = prewarp(sr, frequencyHz);
+        c.k = 1.0f / (bellQ * A);
+        c.m0 = 1.0f;
+        c.m1 = c.k * (A * A - 1.0f);
+        c.m2 = 0.0f;
+        break;
+
+    case Shape::Flat:
+    default:
+        // Pass-through; setDesign keeps the running g/k
+        c.g = prewarp(sr, frequencyHz);
+        break;
+    }
+
+    return d;
+}
+
+void SidechainFilterBank::setDesign(const Design& newDesign)
+{
+    if (newDesign.highPassHz != hpfCutoff)
+    {
+        hpfCutoff = newDesign.highPassHz;
+        highPass.setTarget(newDesign.highPass, !prepared);
+    }
+
+    if (newDesign.shape == currentShape && newDesign.shapeFrequencyHz == shapeFrequency && newDesign.shapeGainDB == shapeGain)
+        return;
+
+    currentShape = newDesign.shape;
+    shapeFrequency = newDesign.shapeFrequencyHz;
+    shapeGain = newDesign.shapeGainDB;
+
+    Coefficients c = newDesign.shaping;
+
+    if (currentShape == Shape::Flat)
+    {
+        // Keep the current g/k so a later shape change glides from a sensible place
+        if (shaping.target.g > 0.0f)
+            c.g = shaping.target.g;
+        c.k = shaping.target.k;
+    }
+
+    shaping.setTarget(c, !prepared);
+}
+
+void SidechainFilterBank::process(const float* const* input, float* const* output, int numChannels, int numSamples)
+{
+    assert(numChannels <= maxChannels);
+    prepared = true;
+
+    Lanes lanes {};
+    const bool shapingActive = !shaping.isBypassed();
+
+    if (!shapingActive)
+        shaping.reset();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            lanes.v[ch] = input[ch][i];
+
+        highPass.processSample(lanes);
+
+        if (shapingActive)
+            shaping.processSample(lanes);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            output[ch][i] = lanes.v[ch];
+    }
+}
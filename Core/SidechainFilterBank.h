@@ -0,0 +1,85 @@
+#pragma once
+
+//==============================================================================
+// Detector EQ: a fixed high-pass plus one selectable shaping section (tilt or bell).
+// Both are Simper/Zavalishin TPT state-variable sections with the channels
+// interleaved in fixed-width lanes, so every channel is filtered in a single pass
+// whose inner loop the compiler turns into SIMD.
+// Designing the coefficient targets (tan/pow) is separate from applying them, so the
+// design can run off the audio thread; applying only restarts a glide for sections
+// whose settings moved, and the running coefficients reach them over rampLengthSamples.
+class SidechainFilterBank
+{
+public:
+    enum class Shape
+    {
+        Flat = 0,
+        Tilt,   // -gain/2 below, +gain/2 above the pivot
+        Bell    // de-essing / kick focus
+    };
+
+    static constexpr int maxChannels = 8;
+
+    struct Coefficients
+    {
+        float g = 0.0f, k = 1.0f, m0 = 1.0f, m1 = 0.0f, m2 = 0.0f;
+    };
+
+    // Coefficient targets for both sections plus the settings they came from
+    struct Design
+    {
+        float highPassHz = -1.0f;
+        Shape shape = Shape::Flat;
+        float shapeFrequencyHz = -1.0f;
+        float shapeGainDB = 0.0f;
+        Coefficients highPass, shaping;
+    };
+
+    // Pure function of its arguments; safe on any thread
+    static Design design(double sampleRate, float highPassHz, Shape shape, float frequencyHz, float gainDB);
+
+    void prepare();
+    void reset();
+
+    // Cheap enough for the audio thread
+    void setDesign(const Design& newDesign);
+
+    // Filters numSamples of up to maxChannels channels (input and output may alias)
+    void process(const float* const* input, float* const* output, int numChannels, int numSamples);
+
+private:
+    struct alignas(32) Lanes
+    {
+        float v[maxChannels];
+    };
+
+    struct Section
+    {
+        Coefficients current, target, step;
+        int rampRemaining = 0;
+        float a1 = 1.0f, a2 = 0.0f, a3 = 0.0f;
+        Lanes ic1eq {}, ic2eq {};
+
+        void setTarget(const Coefficients& newTarget, bool snap);
+        void updateDerived();
+        void reset();
+        bool isBypassed() const;
+        void advanceRamp();
+        void processSample(Lanes& x);
+    };
+
+    Section highPass, shaping;
+
+    float hpfCutoff = -1.0f;
+    Shape currentShape = Shape::Flat;
+    float shapeFrequency = -1.0f;
+    float shapeGain = 0.0f;
+    bool prepared = false;
+
+    static constexpr int rampLengthSamples = 64;
+    static constexpr float butterworthDamping = 1.41421356f; // k = 1/Q, Q = 0.707
+    static constexpr float tiltDamping = 2.0f;                // Q = 0.5, gentle shelf
+    static constexpr float bellQ = 1.4f;
+
+    static float prewarp(double sampleRate, float frequencyHz);
+};
@@ -0,0 +1,287 @@
+#include "Telemetry.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_WIN32)
+ #define WIN32_LEAN_AND_MEAN
+ #define NOMINMAX
+ #include <windows.h>
+#else
+ #include <cerrno>
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+namespace Telemetry
+{
+    namespace
+    {
+#if defined(_WIN32)
+        const char* const segmentName = "Local\\mixcomp_telemetry";
+
+        std::uint32_t currentProcess() { return static_cast<std::uint32_t>(GetCurrentProcessId()); }
+
+        bool isProcessAlive(std::uint32_t pid)
+        {
+            HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+            if (process == nullptr)
+                return GetLastError() == ERROR_ACCESS_DENIED;
+
+            const bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+            CloseHandle(process);
+            return alive;
+        }
+#else
+        const char* const segmentName = "/mixcomp_telemetry";
+
+        std::uint32_t currentProcess() { return static_cast<std::uint32_t>(getpid()); }
+
+        bool isProcessAlive(std::uint32_t pid)
+        {
+            return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+        }
+#endif
+
+        void writeLabel(Slot& slot, const char* label)
+        {
+            char padded[sizeof(slot.label)] = {};
+            if (label != nullptr)
+                std::strncpy(padded, label, maxLabelLength);
+
+            const auto sequence = slot.labelSequence.load(std::memory_order_relaxed);
+            slot.labelSequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (size_t i = 0; i < sizeof(slot.label) / sizeof(std::uint64_t); ++i)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, padded + i * sizeof(word), sizeof(word));
+                slot.label[i].store(word, std::memory_order_relaxed);
+            }
+
+            slot.labelSequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        // Seqlock read of words guarded by sequence; false if a writer kept interfering
+        template <size_t numWords>
+        bool readWords(const std::atomic<std::uint32_t>& sequence, const std::atomic<std::uint64_t> (&source)[numWords], void* destination)
+        {
+            std::uint64_t words[numWords];
+
+            for (int attempt = 0; attempt < 16; ++attempt)
+            {
+                const auto before = sequence.load(std::memory_order_acquire);
+                if ((before & 1u) != 0)
+                    continue;
+
+                for (size_t i = 0; i < numWords; ++i)
+                    words[i] = source[i].load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (sequence.load(std::memory_order_relaxed) == before)
+                {
+                    std::memcpy(destination, words, sizeof(words));
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    }
+
+    //==============================================================================
+    bool Mapping::open(bool writable)
+    {
+        close();
+
+        const size_t size = sizeof(Segment);
+        void* address = nullptr;
+
+#if defined(_WIN32)
+        HANDLE mappingHandle = writable
+            ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), segmentName)
+            : OpenFileMappingA(FILE_MAP_READ, FALSE, segmentName);
+
+        if (mappingHandle == nullptr)
+            return false;
+
+        address = MapViewOfFile(mappingHandle, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+
+        if (address == nullptr)
+        {
+            CloseHandle(mappingHandle);
+            return false;
+        }
+
+        handle = mappingHandle;
+#else
+        const int fd = writable ? shm_open(segmentName, O_RDWR | O_CREAT, 0600)
+                                : shm_open(segmentName, O_RDONLY, 0);
+        if (fd < 0)
+            return false;
+
+        // Every writer sizes it the same; new pages read as zero (all slots free)
+        struct stat info;
+        const bool sized = fstat(fd, &info) == 0
+            && (static_cast<size_t>(info.st_size) >= size || (writable && ftruncate(fd, static_cast<off_t>(size)) == 0));
+
+        if (sized)
+            address = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+
+        ::close(fd);
+
+        if (address == nullptr || address == MAP_FAILED)
+            return false;
+#endif
+
+        segment = static_cast<Segment*>(address);
+
+        if (writable)
+        {
+            // First writer stamps the layout; a segment from another layout version is left alone
+            std::uint32_t expected = 0;
+            if (segment->magic.compare_exchange_strong(expected, segmentMagic))
+                segment->version.store(layoutVersion, std::memory_order_release);
+        }
+
+        if (segment->magic.load(std::memory_order_acquire) != segmentMagic
+            || segment->version.load(std::memory_order_acquire) != layoutVersion)
+        {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void Mapping::close()
+    {
+        if (segment == nullptr)
+            return;
+
+#if defined(_WIN32)
+        UnmapViewOfFile(segment);
+        CloseHandle(static_cast<HANDLE>(handle));
+#else
+        munmap(segment, sizeof(Segment));
+#endif
+
+        segment = nullptr;
+        handle = nullptr;
+    }
+
+    //==============================================================================
+    bool Publisher::attach(const char* label)
+    {
+        detach();
+
+        if (!mapping.open(true))
+            return false;
+
+        const auto process = currentProcess();
+
+        for (auto& candidate : mapping.get()->slots)
+        {
+            auto owner = candidate.ownerProcess.load(std::memory_order_relaxed);
+
+            if (owner != 0 && (owner == process || isProcessAlive(owner)))
+                continue;
+
+            if (candidate.ownerProcess.compare_exchange_strong(owner, process, std::memory_order_acq_rel))
+            {
+                slot = &candidate;
+                break;
+            }
+        }
+
+        if (slot == nullptr)
+        {
+            mapping.close();
+            return false;
+        }
+
+        // Continue the slot's sequence so readers never see it move backwards
+        sequence = slot->sequence.load(std::memory_order_relaxed) & ~1u;
+        writeLabel(*slot, label);
+        publish(Record());
+        return true;
+    }
+
+    void Publisher::detach()
+    {
+        if (slot == nullptr)
+            return;
+
+        slot->ownerProcess.store(0, std::memory_order_release);
+        slot = nullptr;
+        mapping.close();
+    }
+
+    void Publisher::setLabel(const char* label)
+    {
+        if (slot != nullptr)
+            writeLabel(*slot, label);
+    }
+
+    void Publisher::publish(const Record& record)
+    {
+        if (slot == nullptr)
+            return;
+
+        std::uint64_t words[recordWords];
+        std::memcpy(words, &record, sizeof(words));
+
+        slot->sequence.store(++sequence, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < recordWords; ++i)
+            slot->record[i].store(words[i], std::memory_order_relaxed);
+
+        slot->sequence.store(++sequence, std::memory_order_release);
+    }
+
+    //==============================================================================
+    int readAll(const Segment& segment, Entry* entries, int maxEntries)
+    {
+        int numEntries = 0;
+
+        for (int i = 0; i < maxSlots && numEntries < maxEntries; ++i)
+        {
+            const auto& slot = segment.slots[i];
+            auto& entry = entries[numEntries];
+
+            entry.ownerProcess = slot.ownerProcess.load(std::memory_order_acquire);
+            if (entry.ownerProcess == 0)
+                continue;
+
+            entry.slotIndex = i;
+
+            if (!readWords(slot.labelSequence, slot.label, entry.label)
+                || !readWords(slot.sequence, slot.record, &entry.record))
+                continue;
+
+            entry.label[maxLabelLength] = '\0';
+            ++numEntries;
+        }
+
+        return numEntries;
+    }
+
+    std::uint64_t now()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    bool isEnabledByEnvironment()
+    {
+        const char* setting = std::getenv("MIXCOMP_TELEMETRY");
+        return setting != nullptr && std::strcmp(setting, "1") == 0;
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//==============================================================================
+// Session-wide telemetry: every instance on the machine publishes a fixed-layout record
+// into one shared-memory segment, which tools/mixcomp_telemetry lists. Each slot is a
+// seqlock: a publish is a sequence bump, a dozen relaxed word stores and a second bump,
+// with no syscalls, locks or allocations; readers retry while a write is in flight.
+// Mapping the segment and claiming or releasing a slot happen on a control thread.
+namespace Telemetry
+{
+    constexpr std::uint32_t segmentMagic = 0x3154434d;     // "MCT1"
+    constexpr std::uint32_t layoutVersion = 1;
+    constexpr int maxSlots = 256;
+    constexpr int maxLabelLength = 47;
+
+    // One instance's values, as published and as read back
+    struct Record
+    {
+        float gainReductionDB = 0.0f;
+        float inputRMS = 0.0f;              // linear
+        float outputRMS = 0.0f;             // linear
+        float sampleRate = 0.0f;
+        std::uint64_t clipCount = 0;        // channel sub-blocks the soft clip took to full scale
+        std::uint64_t callbackCount = 0;
+        float callbackMeanMicros = 0.0f;    // smoothed
+        float callbackMaxMicros = 0.0f;     // since prepare
+        float load = 0.0f;                  // smoothed callback time / deadline
+        std::int32_t blockSize = 0;         // last callback
+        std::int32_t qualityTier = 0;
+        std::uint32_t reserved = 0;
+        std::uint64_t timestampNanos = 0;   // steady clock at publish; stale means stopped
+    };
+
+    static_assert(sizeof(Record) % sizeof(std::uint64_t) == 0, "Record is copied as whole words");
+    constexpr int recordWords = static_cast<int>(sizeof(Record) / sizeof(std::uint64_t));
+
+    // Shared layout; every field is a lock-free atomic, so access across processes is race-free
+    struct Slot
+    {
+        std::atomic<std::uint32_t> ownerProcess;    // 0 = free
+        std::atomic<std::uint32_t> sequence;        // odd while the audio thread writes
+        std::atomic<std::uint32_t> labelSequence;   // odd while a control thread writes the label
+        std::atomic<std::uint32_t> padding;
+        std::atomic<std::uint64_t> label[(maxLabelLength + 1) / 8];
+        std::atomic<std::uint64_t> record[recordWords];
+    };
+
+    struct Segment
+    {
+        std::atomic<std::uint32_t> magic;
+        std::atomic<std::uint32_t> version;
+        Slot slots[maxSlots];
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared atomics must be address-free");
+
+    // The machine-wide segment; created zeroed by the first writer, readable only by its user
+    class Mapping
+    {
+    public:
+        Mapping() = default;
+        ~Mapping() { close(); }
+
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(const Mapping&) = delete;
+
+        // Readers map read-only and fail when no writer has created the segment yet
+        bool open(bool writable);
+        void close();
+
+        Segment* get() const { return segment; }
+
+    private:
+        Segment* segment = nullptr;
+        void* handle = nullptr;
+    };
+
+    class Publisher
+    {
+    public:
+        Publisher() = default;
+        ~Publisher() { detach(); }
+
+        Publisher(const Publisher&) = delete;
+        Publisher& operator=(const Publisher&) = delete;
+
+        // Not concurrent with publish(); false if the segment cannot be mapped or is full.
+        // Slots left behind by processes that died are reclaimed.
+        bool attach(const char* label);
+        void detach();
+        bool isAttached() const { return slot != nullptr; }
+
+        // Any control thread, also while publishing
+        void setLabel(const char* label);
+
+        // Audio thread
+        void publish(const Record& record);
+
+    private:
+        Mapping mapping;
+        Slot* slot = nullptr;
+        std::uint32_t sequence = 0;
+    };
+
+    // One claimed slot, copied out consistently
+    struct Entry
+    {
+        int slotIndex = 0;
+        std::uint32_t ownerProcess = 0;
+        char label[maxLabelLength + 1] = {};
+        Record record;
+    };
+
+    // Copies every claimed slot into entries; slots still mid-write after a few retries
+    // are skipped. Returns the number of entries written.
+    int readAll(const Segment& segment, Entry* entries, int maxEntries);
+
+    // Current steady clock, comparable across processes on the same machine
+    std::uint64_t now();
+
+    // True only when the MIXCOMP_TELEMETRY environment variable is "1" (publishing is opt-in)
+    bool isEnabledByEnvironment();
+}
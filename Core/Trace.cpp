@@ -0,0 +1,199 @@
+#include "Trace.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace Trace
+{
+    std::atomic<bool> enabled{ false };
+
+    namespace
+    {
+        // Bounded multi-producer ring (Vyukov): a cell's sequence says whose turn it is
+        struct Cell
+        {
+            std::atomic<std::uint64_t> sequence{ 0 };
+            Event event;
+        };
+
+        constexpr std::uint64_t ringMask = ringCapacity - 1;
+        static_assert((ringCapacity & (ringCapacity - 1)) == 0, "ring capacity must be a power of two");
+
+        struct Session
+        {
+            Cell cells[ringCapacity];
+            std::atomic<std::uint64_t> enqueuePosition{ 0 };
+            std::uint64_t dequeuePosition = 0;
+            std::atomic<std::uint64_t> dropped{ 0 };
+
+            std::FILE* file = nullptr;
+            std::uint64_t originNanos = 0;
+            bool firstEvent = true;
+
+            std::thread drainer;
+            std::mutex lock;
+            std::condition_variable wake;
+            bool shouldExit = false;
+        };
+
+        Session& getSession()
+        {
+            static Session session;
+            return session;
+        }
+
+        std::atomic<std::uint32_t> nextThreadId{ 1 };
+
+        std::uint32_t currentThreadId()
+        {
+            thread_local const std::uint32_t id = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+            return id;
+        }
+
+        void writeEvent(Session& session, const Event& event)
+        {
+            const double startMicros = static_cast<double>(event.startNanos - session.originNanos) * 1.0e-3;
+            const double durationMicros = static_cast<double>(event.durationNanos) * 1.0e-3;
+
+            std::fprintf(session.file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"value\":%d}}",
+                         session.firstEvent ? "" : ",", event.name, event.thread, startMicros, durationMicros, event.value);
+            session.firstEvent = false;
+        }
+
+        void drain(Session& session)
+        {
+            for (;;)
+            {
+                auto& cell = session.cells[session.dequeuePosition & ringMask];
+
+                if (cell.sequence.load(std::memory_order_acquire) != session.dequeuePosition + 1)
+                    return;
+
+                const Event event = cell.event;
+                cell.sequence.store(session.dequeuePosition + ringCapacity, std::memory_order_release);
+                ++session.dequeuePosition;
+
+                writeEvent(session, event);
+            }
+        }
+
+        void runDrainer(Session& session)
+        {
+            std::unique_lock<std::mutex> guard(session.lock);
+
+            while (!session.shouldExit)
+            {
+                guard.unlock();
+                drain(session);
+                guard.lock();
+
+                session.wake.wait_for(guard, std::chrono::milliseconds(2), [&session] { return session.shouldExit; });
+            }
+        }
+    }
+
+    //==============================================================================
+    bool start(const char* path)
+    {
+#if MIXCOMP_TRACING
+        auto& session = getSession();
+
+        if (session.file != nullptr || path == nullptr)
+            return false;
+
+        session.file = std::fopen(path, "w");
+        if (session.file == nullptr)
+            return false;
+
+        for (std::uint64_t i = 0; i < static_cast<std::uint64_t>(ringCapacity); ++i)
+            session.cells[i].sequence.store(i, std::memory_order_relaxed);
+
+        session.enqueuePosition.store(0, std::memory_order_relaxed);
+        session.dequeuePosition = 0;
+        session.dropped.store(0, std::memory_order_relaxed);
+        session.originNanos = now();
+        session.firstEvent = true;
+        session.shouldExit = false;
+
+        std::fprintf(session.file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+        session.drainer = std::thread([&session] { runDrainer(session); });
+
+        enabled.store(true, std::memory_order_release);
+        return true;
+#else
+        (void) path;
+        return false;
+#endif
+    }
+
+    std::uint64_t stop()
+    {
+        auto& session = getSession();
+
+        if (session.file == nullptr)
+            return 0;
+
+        enabled.store(false, std::memory_order_release);
+
+        {
+            std::lock_guard<std::mutex> guard(session.lock);
+            session.shouldExit = true;
+        }
+
+        session.wake.notify_one();
+        session.drainer.join();
+
+        drain(session);
+        std::fprintf(session.file, "\n]}\n");
+        std::fclose(session.file);
+        session.file = nullptr;
+
+        return session.dropped.load(std::memory_order_relaxed);
+    }
+
+    void record(const char* name, std::uint64_t startNanos, std::uint64_t endNanos, std::int32_t value)
+    {
+        auto& session = getSession();
+        auto position = session.enqueuePosition.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = session.cells[position & ringMask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::int64_t>(sequence - position);
+
+            if (lag == 0)
+            {
+                if (session.enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.event.name = name;
+                    cell.event.startNanos = startNanos;
+                    cell.event.durationNanos = static_cast<std::uint32_t>(endNanos - startNanos);
+                    cell.event.thread = currentThreadId();
+                    cell.event.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return;
+                }
+            }
+            else if (lag < 0)
+            {
+                // Drainer is a whole ring behind
+                session.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else
+            {
+                position = session.enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::uint64_t now()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
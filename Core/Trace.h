@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+//==============================================================================
+// Optional scoped trace events for per-block timelines, written as Chrome trace JSON
+// (chrome://tracing, ui.perfetto.dev). While a trace runs, each scope pushes one complete
+// event into a preallocated lock-free ring and a background thread drains the ring to the
+// file; events that find the ring full are counted and dropped. Otherwise a scope costs a
+// relaxed load. Builds without MIXCOMP_TRACING compile the scopes out entirely.
+namespace Trace
+{
+    // Slot count of the ring (events, not bytes)
+    constexpr int ringCapacity = 1 << 16;
+
+    struct Event
+    {
+        const char* name = nullptr;     // string literal
+        std::uint64_t startNanos = 0;
+        std::uint32_t durationNanos = 0;
+        std::uint32_t thread = 0;
+        std::int32_t value = 0;         // written as args.value (sample count, tier, ...)
+    };
+
+    extern std::atomic<bool> enabled;
+    inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Control thread. start() truncates path and fails if a trace already runs or tracing is
+    // compiled out; stop() writes the remaining events, closes the file and returns the number
+    // of events dropped. Stop only once the traced threads are idle.
+    bool start(const char* path);
+    std::uint64_t stop();
+
+    // Any thread; wait-free apart from a CAS retry against other producers
+    void record(const char* name, std::uint64_t startNanos, std::uint64_t endNanos, std::int32_t value);
+
+    std::uint64_t now();
+
+    class Scope
+    {
+    public:
+        explicit Scope(const char* eventName, std::int32_t eventValue = 0)
+            : name(isEnabled() ? eventName : nullptr), value(eventValue), startNanos(name != nullptr ? now() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (name != nullptr)
+                record(name, startNanos, now(), value);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        std::int32_t value;
+        std::uint64_t startNanos;
+    };
+}
+
+#if MIXCOMP_TRACING
+ #define MIXCOMP_TRACE_CONCAT_INNER(a, b) a##b
+ #define MIXCOMP_TRACE_CONCAT(a, b) MIXCOMP_TRACE_CONCAT_INNER(a, b)
+ #define MIXCOMP_TRACE_SCOPE(name, value) Trace::Scope MIXCOMP_TRACE_CONCAT(traceScope, __LINE__)(name, value)
+#else
+ #define MIXCOMP_TRACE_SCOPE(name, value)
+#endif
@@ -0,0 +1,68 @@
+#include "TruePeakDetector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+
+namespace
+{
+    // BS.1770-4 Annex 2 interpolator, one row per phase, newest input first
+    const float phaseCoefficients[TruePeakDetector::oversampling][TruePeakDetector::tapsPerPhase] = {
+        {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f, -0.0594482421875f,  0.1373291015625f,
+           0.9721679687500f, -0.1022949218750f,  0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+        { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f, -0.1665039062500f,  0.4650878906250f,
+           0.7797851562500f, -0.2003173828125f,  0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+        { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f, -0.2003173828125f,  0.7797851562500f,
+           0.4650878906250f, -0.1665039062500f,  0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+        { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f, -0.1022949218750f,  0.9721679687500f,
+           0.1373291015625f, -0.0594482421875f,  0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f }
+    };
+}
+
+//==============================================================================
+void TruePeakDetector::reset()
+{
+    for (auto& channelHistory : history)
+        std::fill(std::begin(channelHistory), std::end(channelHistory), 0.0f);
+
+    writePos = 0;
+}
+
+void TruePeakDetector::process(float* const* channels, int numChannels, int numSamples)
+{
+    assert(numChannels <= maxChannels);
+
+    int pos = writePos;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* samples = channels[channel];
+        auto* channelHistory = history[channel];
+        pos = writePos;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Newest sample at the window start: the window runs backwards in time
+            pos = (pos == 0 ? tapsPerPhase : pos) - 1;
+            channelHistory[pos] = samples[i];
+            channelHistory[pos + tapsPerPhase] = samples[i];
+
+            const float* window = channelHistory + pos;
+            float peak = std::fabs(samples[i]);
+
+            for (int phase = 0; phase < oversampling; ++phase)
+            {
+                float sum = 0.0f;
+                for (int tap = 0; tap < tapsPerPhase; ++tap)
+                    sum += phaseCoefficients[phase][tap] * window[tap];
+
+                peak = std::max(peak, std::fabs(sum));
+            }
+
+            samples[i] = peak;
+        }
+    }
+
+    writePos = pos;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+//==============================================================================
+// Inter-sample peak detection for the detector path: 4x polyphase interpolation with the
+// ITU-R BS.1770-4 (Annex 2) filter, keeping the larger of the sample magnitude and the
+// interpolated magnitudes. The interpolated points trail the input by about half the
+// filter length (~6 samples); the sample itself is not delayed, so onsets are not late.
+class TruePeakDetector
+{
+public:
+    static constexpr int maxChannels = 8;
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+
+    void reset();
+
+    // In place: every sample becomes its true-peak magnitude
+    void process(float* const* channels, int numChannels, int numSamples);
+
+private:
+    // Input history written twice so each window is a contiguous read
+    float history[maxChannels][2 * tapsPerPhase] = {};
+    int writePos = 0;
+};
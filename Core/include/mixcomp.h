@@ -0,0 +1,244 @@
+/*
+    MixCompressor core - plain C API
+
+    The same dual-stage compressor engine the plugin runs, usable from any process
+    without JUCE, a message thread or a GUI. One engine instance is not thread-safe:
+    create/prepare/set_params/process/reset must be called from one thread at a time.
+    The meter getters may be called from any thread.
+
+    Typical use:
+        mixcomp_engine* e = mixcomp_create();
+        mixcomp_params p;
+        mixcomp_default_params(&p);
+        p.threshold1_db = -18.0f;
+        mixcomp_prepare(e, 48000.0, 2);
+        mixcomp_set_params(e, &p);
+        mixcomp_process(e, channels, 2, numSamples);   // planar, in place
+        mixcomp_destroy(e);
+*/
+
+#ifndef MIXCOMP_H_INCLUDED
+#define MIXCOMP_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIXCOMP_MAX_CHANNELS 8
+#define MIXCOMP_MAX_SWEEP_VARIANTS 16
+
+typedef enum mixcomp_result
+{
+    MIXCOMP_OK = 0,
+    MIXCOMP_ERROR_INVALID_ARGUMENT = -1,
+    MIXCOMP_ERROR_NOT_PREPARED = -2,
+    MIXCOMP_ERROR_UNSUPPORTED = -3
+} mixcomp_result;
+
+typedef enum mixcomp_topology
+{
+    MIXCOMP_TOPOLOGY_VCA = 0,       /* clean, odd harmonics */
+    MIXCOMP_TOPOLOGY_FET = 1,       /* aggressive, 2nd + 3rd harmonics */
+    MIXCOMP_TOPOLOGY_OPTICAL = 2    /* smooth, program-dependent */
+} mixcomp_topology;
+
+typedef enum mixcomp_sc_eq
+{
+    MIXCOMP_SC_EQ_FLAT = 0,
+    MIXCOMP_SC_EQ_TILT = 1,
+    MIXCOMP_SC_EQ_BELL = 2
+} mixcomp_sc_eq;
+
+typedef enum mixcomp_detector_rate
+{
+    MIXCOMP_DETECTOR_AUTO = 0,      /* decimate the detector when the time constants allow it */
+    MIXCOMP_DETECTOR_AUDIO_RATE = 1
+} mixcomp_detector_rate;
+
+typedef enum mixcomp_link_mode
+{
+    MIXCOMP_LINK_OFF = 0,
+    MIXCOMP_LINK_MAX = 1,           /* detector keys on the loudest member of the link group */
+    MIXCOMP_LINK_SUM = 2            /* detector keys on the summed levels of the group */
+} mixcomp_link_mode;
+
+/* Mirrors the plugin parameters one to one (same units and defaults) */
+typedef struct mixcomp_params
+{
+    int   topology;         /* mixcomp_topology */
+    float sc_hpf_hz;        /* 20 .. 500 */
+    int   sc_eq_shape;      /* mixcomp_sc_eq */
+    float sc_eq_freq_hz;    /* 50 .. 12000 */
+    float sc_eq_gain_db;    /* -12 .. 12 */
+
+    float threshold1_db;    /* -60 .. 0 */
+    float ratio1;           /* 1 .. 10 */
+    float attack1_ms;       /* 0.1 .. 500 */
+    float release1_ms;      /* 20 .. 2000 */
+
+    int   dual_stage;       /* 0 / 1 */
+    float threshold2_db;    /* -60 .. 0 */
+    float ratio2;           /* 1 .. 20 */
+    float attack2_ms;       /* 0.01 .. 100 */
+    float release2_ms;      /* 20 .. 500 */
+
+    float knee_db;          /* 0 .. 24 */
+    float makeup_db;        /* 0 .. 24 */
+    int   auto_makeup;      /* 0 / 1 */
+    float mix_percent;      /* 0 .. 100 */
+    int   detector_rate;    /* mixcomp_detector_rate */
+    int   link_mode;        /* mixcomp_link_mode; needs a link group */
+
+    int   adaptive_quality;     /* 0 / 1: step down quality tiers when over the CPU budget */
+    float cpu_budget_percent;   /* 1 .. 100, share of each call's real-time deadline */
+
+    int   true_peak_detect;     /* 0 / 1: detectors see 4x interpolated inter-sample peaks */
+    int   double_precision;     /* 0 / 1: audio-rate envelope and gain smoothing in double */
+
+    /* Below threshold1_db, on the stage 1 detector: upward compression (boost up to 12 dB)
+       and downward expansion / gate under it. A ratio of 1 turns either off. */
+    float upward_threshold_db;   /* -60 .. 0, capped at threshold1_db */
+    float upward_ratio;          /* 1 .. 4 */
+    float expander_threshold_db; /* -80 .. 0 */
+    float expander_ratio;        /* 1 .. 20 (20 acts as a gate) */
+    float expander_range_db;     /* 0 .. 40, deepest attenuation */
+
+    /* Output stage: the fixed soft clip, or a look-ahead brickwall limiter in its place
+       whose look-ahead (1.5 ms) becomes the engine's latency, see mixcomp_get_latency */
+    int   output_limiter;        /* 0 / 1 */
+    float limiter_ceiling_db;    /* -24 .. 0 */
+    float limiter_release_ms;    /* 1 .. 1000 */
+} mixcomp_params;
+
+typedef struct mixcomp_meters
+{
+    float gain_reduction_db;    /* peak GR with 300 ms release */
+    float input_rms;            /* linear, 300 ms integration */
+    float output_rms;           /* linear, 300 ms integration */
+    int   quality_tier;         /* 0 full, 1 gain curve table, 2 table + control-rate detector */
+    float cpu_load;             /* smoothed process time / deadline (adaptive quality only) */
+} mixcomp_meters;
+
+typedef struct mixcomp_engine mixcomp_engine;
+
+mixcomp_engine* mixcomp_create(void);
+void mixcomp_destroy(mixcomp_engine* engine);
+
+void mixcomp_default_params(mixcomp_params* params);
+
+/* Allocation-free from here on; may be called again to change rate or channel count */
+mixcomp_result mixcomp_prepare(mixcomp_engine* engine, double sample_rate, int num_channels);
+void mixcomp_reset(mixcomp_engine* engine);
+
+/* Takes effect on the engine's next 32-sample parameter boundary */
+mixcomp_result mixcomp_set_params(mixcomp_engine* engine, const mixcomp_params* params);
+
+/* Planar float buffers, processed in place; any num_samples >= 0 */
+mixcomp_result mixcomp_process(mixcomp_engine* engine, float* const* channels, int num_channels, int num_samples);
+
+/* Offline renders of long buffers (pass the whole file): bit-identical to mixcomp_process, with
+   the side-chain run over the buffer first and the audio-rate detectors' envelope recurrences
+   split into chunks evaluated side by side in SIMD lanes on num_threads threads (0 = all
+   cores). Only those recurrences run in parallel, so the gain is bounded by their share of
+   the render (mixcomp_bench --offline 1 measures it). It takes two threads on two cores and
+   2^20 samples (about 22 s at 48 kHz) to pay off; with less, or detectors at a control rate
+   (detector_rate auto picks one for slow time constants) or in double precision, the call
+   processes exactly as mixcomp_process, as do linked, replaying, adaptive-quality and
+   background-prepared engines. Allocates a buffer per channel and stage; not for realtime
+   use. */
+mixcomp_result mixcomp_process_offline(mixcomp_engine* engine, float* const* channels, int num_channels, int num_samples,
+                                       int num_threads);
+
+void mixcomp_get_meters(const mixcomp_engine* engine, mixcomp_meters* meters);
+/* Samples the output is delayed by for the current parameters (0 unless output_limiter) */
+int mixcomp_get_latency(const mixcomp_engine* engine);
+
+/* Gain-curve capture and replay for cheap offline re-renders. Every processed sample yields
+   a frame of mixcomp_gain_curve_frame_size() floats: the combined gain reduction (dB) the
+   meters and auto makeup use, then per channel the linear gain stage 1 (and stage 2 with
+   dual_stage) applied. The recorder is handed the frames as they are produced; during
+   replay the engine pulls them from the player instead of running the side-chain and the
+   detectors (a player returning 0 has run dry and yields unity gain). Replaying frames
+   recorded with parameters for which mixcomp_same_gain_curve() holds is bit-identical to a
+   full render, while makeup, mix, topology and the output stage are free to differ. Both
+   run at the full quality tier (adaptive_quality is ignored); NULL turns either off. Not
+   concurrent with mixcomp_process. */
+typedef void (*mixcomp_gain_curve_recorder)(void* context, const float* frames, int num_samples);
+typedef int (*mixcomp_gain_curve_player)(void* context, float* frames, int num_samples);
+
+int mixcomp_gain_curve_frame_size(int num_channels, int dual_stage);
+mixcomp_result mixcomp_set_gain_curve_recorder(mixcomp_engine* engine, mixcomp_gain_curve_recorder recorder, void* context);
+mixcomp_result mixcomp_set_gain_curve_player(mixcomp_engine* engine, mixcomp_gain_curve_player player, void* context);
+
+/* Nonzero when both parameter sets drive the detectors identically (same gain curves) */
+int mixcomp_same_gain_curve(const mixcomp_params* a, const mixcomp_params* b);
+
+/* Joins a named detector link group shared by every engine in this process (NULL or ""
+   leaves). Members see each other's detector levels with at most one block of latency.
+   Takes a lock: call from a control thread, not the audio thread. */
+mixcomp_result mixcomp_set_link_group(mixcomp_engine* engine, const char* name);
+
+/* Publishes this engine's meters, clip count and callback timing into the machine-wide
+   shared-memory telemetry segment (listed by the mixcomp_telemetry tool) under the given
+   label; NULL disables. Not concurrent with mixcomp_process. */
+mixcomp_result mixcomp_set_telemetry(mixcomp_engine* engine, const char* label);
+
+/* Process-wide Chrome trace JSON (chrome://tracing, ui.perfetto.dev) of every engine's
+   process calls, parameter updates, resource builds, side-chain and stage passes. Begin
+   fails with MIXCOMP_ERROR_UNSUPPORTED in builds without MIXCOMP_TRACING, while a trace
+   runs, or when the file cannot be created. End (once the engines are idle) writes the
+   rest and returns the number of events dropped because the writer fell behind. */
+mixcomp_result mixcomp_trace_begin(const char* path);
+unsigned long long mixcomp_trace_end(void);
+
+/* Sweep: one input rendered against up to MIXCOMP_MAX_SWEEP_VARIANTS parameter sets in a
+   single pass, for tuning presets. The side-chain EQ, true-peak detection and DC blocker run
+   once for all variants; every variant's two stages run side by side in SIMD lanes. The
+   variants must agree on topology, dual_stage, the sc_* settings and true_peak_detect and
+   may differ in everything else. Detection always runs at the audio rate; adaptive_quality,
+   double_precision, link_mode and the output limiter are ignored. Each variant's audio is
+   bit-identical to a mixcomp_process render of the same parameters with detector_rate set
+   to MIXCOMP_DETECTOR_AUDIO_RATE and those four off (unless curve tables are enabled).
+   Exact, the default, runs about 1.5x faster than rendering the variants one by one; curve
+   tables save little more. */
+typedef struct mixcomp_sweep mixcomp_sweep;
+
+typedef struct mixcomp_sweep_stats
+{
+    float loudness_lufs;        /* BS.1770 gated integrated loudness, channels unweighted (-100 before 400 ms) */
+    float output_peak_db;       /* sample peak */
+    float gr_mean_db;           /* combined gain reduction, mean over samples */
+    float gr_max_db;
+    float gr_active_percent;    /* share of samples with more than 1 dB of gain reduction */
+} mixcomp_sweep_stats;
+
+mixcomp_sweep* mixcomp_sweep_create(void);
+void mixcomp_sweep_destroy(mixcomp_sweep* sweep);
+
+/* Clears all state and statistics. MIXCOMP_ERROR_UNSUPPORTED when the variants disagree on
+   a shared setting. */
+mixcomp_result mixcomp_sweep_prepare(mixcomp_sweep* sweep, double sample_rate, int num_channels,
+                                     const mixcomp_params* variants, int num_variants);
+
+/* Planar input, left untouched. outputs holds num_variants * num_channels planar buffers,
+   variant-major (outputs[variant * num_channels + channel]), or is NULL for statistics only. */
+mixcomp_result mixcomp_sweep_process(mixcomp_sweep* sweep, const float* const* input, float* const* outputs, int num_samples);
+
+/* Nonzero runs every variant's gain curves from lookup tables: within 0.01 dB of the exact
+   curve, no longer bit-identical to a render, and at most slightly faster. The default is
+   off (exact), as in the mixcomp_sweep tool. Applied at the next mixcomp_sweep_prepare */
+mixcomp_result mixcomp_sweep_set_curve_tables(mixcomp_sweep* sweep, int enabled);
+
+/* Statistics over everything processed since prepare */
+mixcomp_result mixcomp_sweep_get_stats(const mixcomp_sweep* sweep, int variant, mixcomp_sweep_stats* stats);
+
+/* Kernel variant override for testing ("generic", "sse2", "avx2", "avx512", "neon" or NULL
+   for automatic: the widest the CPU supports); applied at the next mixcomp_prepare */
+mixcomp_result mixcomp_set_kernel_variant(mixcomp_engine* engine, const char* name);
+const char* mixcomp_get_kernel_variant(const mixcomp_engine* engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MIXCOMP_H_INCLUDED */
@@ -0,0 +1,326 @@
+#include "include/mixcomp.h"
+#include "CompressorEngine.h"
+#include "CompressorSweep.h"
+#include "Trace.h"
+
+#include <cstring>
+#include <new>
+
+//==============================================================================
+// C API: a thin shell over CompressorEngine, nothing here touches audio
+struct mixcomp_engine
+{
+    CompressorEngine engine;
+    bool prepared = false;
+};
+
+struct mixcomp_sweep
+{
+    CompressorSweep sweep;
+    bool prepared = false;
+};
+
+mixcomp_engine* mixcomp_create(void)
+{
+    return new (std::nothrow) mixcomp_engine();
+}
+
+void mixcomp_destroy(mixcomp_engine* engine)
+{
+    delete engine;
+}
+
+void mixcomp_default_params(mixcomp_params* params)
+{
+    if (params == nullptr)
+        return;
+
+    // Same defaults as the plugin's parameter layout
+    params->topology = MIXCOMP_TOPOLOGY_VCA;
+    params->sc_hpf_hz = 80.0f;
+    params->sc_eq_shape = MIXCOMP_SC_EQ_FLAT;
+    params->sc_eq_freq_hz = 1000.0f;
+    params->sc_eq_gain_db = 0.0f;
+
+    params->threshold1_db = -24.0f;
+    params->ratio1 = 4.0f;
+    params->attack1_ms = 10.0f;
+    params->release1_ms = 150.0f;
+
+    params->dual_stage = 0;
+    params->threshold2_db = -12.0f;
+    params->ratio2 = 8.0f;
+    params->attack2_ms = 1.0f;
+    params->release2_ms = 50.0f;
+
+    params->knee_db = 6.0f;
+    params->makeup_db = 0.0f;
+    params->auto_makeup = 1;
+    params->mix_percent = 100.0f;
+    params->detector_rate = MIXCOMP_DETECTOR_AUTO;
+    params->link_mode = MIXCOMP_LINK_OFF;
+    params->adaptive_quality = 0;
+    params->cpu_budget_percent = 10.0f;
+    params->true_peak_detect = 0;
+    params->double_precision = 0;
+    params->upward_threshold_db = -40.0f;
+    params->upward_ratio = 1.0f;
+    params->expander_threshold_db = -60.0f;
+    params->expander_ratio = 1.0f;
+    params->expander_range_db = 40.0f;
+    params->output_limiter = 0;
+    params->limiter_ceiling_db = -0.3f;
+    params->limiter_release_ms = 50.0f;
+}
+
+mixcomp_result mixcomp_prepare(mixcomp_engine* engine, double sample_rate, int num_channels)
+{
+    if (engine == nullptr || !(sample_rate > 0.0) || num_channels < 1 || num_channels > MIXCOMP_MAX_CHANNELS)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    engine->engine.prepare(sample_rate, num_channels);
+    engine->prepared = true;
+    return MIXCOMP_OK;
+}
+
+void mixcomp_reset(mixcomp_engine* engine)
+{
+    if (engine != nullptr && engine->prepared)
+        engine->engine.reset();
+}
+
+mixcomp_result mixcomp_set_params(mixcomp_engine* engine, const mixcomp_params* params)
+{
+    if (engine == nullptr || params == nullptr)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    engine->engine.setParameters(*params);
+    return MIXCOMP_OK;
+}
+
+mixcomp_result mixcomp_process(mixcomp_engine* engine, float* const* channels, int num_channels, int num_samples)
+{
+    if (engine == nullptr || num_channels < 0 || num_samples < 0 || (channels == nullptr && num_channels > 0))
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    if (!engine->prepared)
+        return MIXCOMP_ERROR_NOT_PREPARED;
+
+    for (int ch = 0; ch < num_channels; ++ch)
+        if (channels[ch] == nullptr)
+            return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    engine->engine.process(channels, num_channels, num_samples);
+    return MIXCOMP_OK;
+}
+
+mixcomp_result mixcomp_process_offline(mixcomp_engine* engine, float* const* channels, int num_channels, int num_samples,
+                                       int num_threads)
+{
+    if (engine == nullptr || num_channels < 0 || num_samples < 0 || (channels == nullptr && num_channels > 0))
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    if (!engine->prepared)
+        return MIXCOMP_ERROR_NOT_PREPARED;
+
+    for (int ch = 0; ch < num_channels; ++ch)
+        if (channels[ch] == nullptr)
+            return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    engine->engine.processOffline(channels, num_channels, num_samples, num_threads);
+    return MIXCOMP_OK;
+}
+
+void mixcomp_get_meters(const mixcomp_engine* engine, mixcomp_meters* meters)
+{
+    if (meters == nullptr)
+        return;
+
+    if (engine == nullptr)
+    {
+        *meters = {};
+        return;
+    }
+
+    meters->gain_reduction_db = engine->engine.getGainReduction();
+    meters->input_rms = engine->engine.getInputRMS();
+    meters->output_rms = engine->engine.getOutputRMS();
+    meters->quality_tier = engine->engine.getQualityTier();
+    meters->cpu_load = engine->engine.getCPULoad();
+}
+
+int mixcomp_get_latency(const mixcomp_engine* engine)
+{
+    return engine != nullptr ? engine->engine.getLatencySamples() : 0;
+}
+
+int mixcomp_gain_curve_frame_size(int num_channels, int dual_stage)
+{
+    return CompressorEngine::getGainCurveFrameSize(num_channels, dual_stage != 0);
+}
+
+mixcomp_result mixcomp_set_gain_curve_recorder(mixcomp_engine* engine, mixcomp_gain_curve_recorder recorder, void* context)
+{
+    if (engine == nullptr)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    engine->engine.setGainCurveRecorder(recorder, context);
+    return MIXCOMP_OK;
+}
+
+mixcomp_result mixcomp_set_gain_curve_player(mixcomp_engine* engine, mixcomp_gain_curve_player player, void* context)
+{
+    if (engine == nullptr)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    engine->engine.setGainCurvePlayer(player, context);
+    return MIXCOMP_OK;
+}
+
+int mixcomp_same_gain_curve(const mixcomp_params* a, const mixcomp_params* b)
+{
+    return a != nullptr && b != nullptr && CompressorEngine::hasSameGainCurve(*a, *b) ? 1 : 0;
+}
+
+mixcomp_result mixcomp_set_link_group(mixcomp_engine* engine, const char* name)
+{
+    if (engine == nullptr)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    return engine->engine.setLinkGroup(name) ? MIXCOMP_OK : MIXCOMP_ERROR_UNSUPPORTED;
+}
+
+mixcomp_result mixcomp_set_telemetry(mixcomp_engine* engine, const char* label)
+{
+    if (engine == nullptr)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    if (label == nullptr)
+    {
+        engine->engine.disableTelemetry();
+        return MIXCOMP_OK;
+    }
+
+    return engine->engine.enableTelemetry(label) ? MIXCOMP_OK : MIXCOMP_ERROR_UNSUPPORTED;
+}
+
+mixcomp_result mixcomp_trace_begin(const char* path)
+{
+    if (path == nullptr)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    return Trace::start(path) ? MIXCOMP_OK : MIXCOMP_ERROR_UNSUPPORTED;
+}
+
+unsigned long long mixcomp_trace_end(void)
+{
+    return Trace::stop();
+}
+
+mixcomp_sweep* mixcomp_sweep_create(void)
+{
+    return new (std::nothrow) mixcomp_sweep();
+}
+
+void mixcomp_sweep_destroy(mixcomp_sweep* sweep)
+{
+    delete sweep;
+}
+
+mixcomp_result mixcomp_sweep_prepare(mixcomp_sweep* sweep, double sample_rate, int num_channels,
+                                     const mixcomp_params* variants, int num_variants)
+{
+    if (sweep == nullptr || variants == nullptr || !(sample_rate > 0.0)
+        || num_channels < 1 || num_channels > MIXCOMP_MAX_CHANNELS
+        || num_variants < 1 || num_variants > MIXCOMP_MAX_SWEEP_VARIANTS)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    if (!sweep->sweep.prepare(sample_rate, num_channels, variants, num_variants))
+    {
+        sweep->prepared = false;
+        return MIXCOMP_ERROR_UNSUPPORTED;
+    }
+
+    sweep->prepared = true;
+    return MIXCOMP_OK;
+}
+
+mixcomp_result mixcomp_sweep_process(mixcomp_sweep* sweep, const float* const* input, float* const* outputs, int num_samples)
+{
+    if (sweep == nullptr || input == nullptr || num_samples < 0)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    if (!sweep->prepared)
+        return MIXCOMP_ERROR_NOT_PREPARED;
+
+    const int numChannels = sweep->sweep.getNumChannels();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        if (input[ch] == nullptr)
+            return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    if (outputs != nullptr)
+        for (int i = 0; i < sweep->sweep.getNumVariants() * numChannels; ++i)
+            if (outputs[i] == nullptr)
+                return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    sweep->sweep.process(input, outputs, num_samples);
+    return MIXCOMP_OK;
+}
+
+mixcomp_result mixcomp_sweep_set_curve_tables(mixcomp_sweep* sweep, int enabled)
+{
+    if (sweep == nullptr)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    sweep->sweep.setUseCurveTables(enabled != 0);
+    return MIXCOMP_OK;
+}
+
+mixcomp_result mixcomp_sweep_get_stats(const mixcomp_sweep* sweep, int variant, mixcomp_sweep_stats* stats)
+{
+    if (sweep == nullptr || stats == nullptr)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    if (!sweep->prepared)
+        return MIXCOMP_ERROR_NOT_PREPARED;
+
+    if (variant < 0 || variant >= sweep->sweep.getNumVariants())
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    *stats = sweep->sweep.getStats(variant);
+    return MIXCOMP_OK;
+}
+
+mixcomp_result mixcomp_set_kernel_variant(mixcomp_engine* engine, const char* name)
+{
+    if (engine == nullptr)
+        return MIXCOMP_ERROR_INVALID_ARGUMENT;
+
+    if (name == nullptr)
+    {
+        engine->engine.clearKernelVariantOverride();
+        return MIXCOMP_OK;
+    }
+
+    for (int i = 0; i < static_cast<int>(DSPKernels::Variant::NumVariants); ++i)
+    {
+        const auto variant = static_cast<DSPKernels::Variant>(i);
+
+        if (std::strcmp(name, DSPKernels::getVariantName(variant)) == 0)
+        {
+            if (!DSPKernels::isVariantAvailable(variant))
+                return MIXCOMP_ERROR_UNSUPPORTED;
+
+            engine->engine.setKernelVariantOverride(variant);
+            return MIXCOMP_OK;
+        }
+    }
+
+    return MIXCOMP_ERROR_INVALID_ARGUMENT;
+}
+
+const char* mixcomp_get_kernel_variant(const mixcomp_engine* engine)
+{
+    return engine != nullptr ? DSPKernels::getVariantName(engine->engine.getKernelVariant()) : "";
+}
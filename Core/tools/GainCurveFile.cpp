@@ -0,0 +1,268 @@
+#include "GainCurveFile.h"
+#include "ParamFields.h"
+
+#include <cstring>
+
+namespace GainCurveFile
+{
+    namespace
+    {
+        const char magic[4] = { 'M', 'C', 'G', 'C' };
+        constexpr long numFramesOffset = 24;
+        constexpr std::uint32_t maxParamsLength = 1 << 16;
+        constexpr size_t readBufferSize = 1 << 16;
+
+        void putLittleEndian(std::vector<std::uint8_t>& bytes, std::uint64_t value, int numBytes)
+        {
+            for (int i = 0; i < numBytes; ++i)
+                bytes.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+        }
+
+        std::uint64_t getLittleEndian(const std::uint8_t* bytes, int numBytes)
+        {
+            std::uint64_t value = 0;
+            for (int i = 0; i < numBytes; ++i)
+                value |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+
+            return value;
+        }
+
+        // Bits of the next value on the line through a column's last two; wraps like the deltas
+        std::uint32_t predict(const std::uint32_t* last)
+        {
+            return 2u * last[0] - last[1];
+        }
+
+        std::uint64_t bitsOf(double value)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        // Parameters from ParamFields::toText lines; false on an unknown name
+        bool parseParameters(const std::string& text, mixcomp_params& params)
+        {
+            mixcomp_default_params(&params);
+
+            for (size_t start = 0; start < text.size();)
+            {
+                size_t end = text.find('\n', start);
+                if (end == std::string::npos)
+                    end = text.size();
+
+                const std::string line = text.substr(start, end - start);
+                const size_t space = line.find(' ');
+                if (space == std::string::npos || !ParamFields::set(params, line.substr(0, space).c_str(), line.c_str() + space + 1))
+                    return false;
+
+                start = end + 1;
+            }
+
+            return true;
+        }
+    }
+
+    bool Writer::open(const std::string& path, double sampleRate, int numChannels, const mixcomp_params& params, std::string& error)
+    {
+        close();
+
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+        {
+            error = "cannot create " + path;
+            return false;
+        }
+
+        header = Header();
+        header.numChannels = static_cast<std::uint32_t>(numChannels);
+        header.frameSize = static_cast<std::uint32_t>(mixcomp_gain_curve_frame_size(numChannels, params.dual_stage));
+        header.sampleRate = sampleRate;
+        header.params = params;
+        history.assign(2 * header.frameSize, 0);
+
+        const std::string paramsText = ParamFields::toText(params);
+
+        encoded.assign(magic, magic + sizeof(magic));
+        putLittleEndian(encoded, version, 4);
+        putLittleEndian(encoded, header.numChannels, 4);
+        putLittleEndian(encoded, header.frameSize, 4);
+        putLittleEndian(encoded, bitsOf(sampleRate), 8);
+        putLittleEndian(encoded, 0, 8);
+        putLittleEndian(encoded, paramsText.size(), 4);
+        encoded.insert(encoded.end(), paramsText.begin(), paramsText.end());
+
+        failed = std::fwrite(encoded.data(), 1, encoded.size(), file) != encoded.size();
+
+        if (failed)
+            error = "cannot write " + path;
+
+        return !failed;
+    }
+
+    bool Writer::close()
+    {
+        if (file == nullptr)
+            return !failed;
+
+        // Frame count at its place in the header
+        encoded.clear();
+        putLittleEndian(encoded, header.numFrames, 8);
+
+        if (std::fseek(file, numFramesOffset, SEEK_SET) != 0 || std::fwrite(encoded.data(), 1, encoded.size(), file) != encoded.size())
+            failed = true;
+
+        if (std::fclose(file) != 0)
+            failed = true;
+
+        file = nullptr;
+        return !failed;
+    }
+
+    void Writer::attach(mixcomp_engine* engine)
+    {
+        mixcomp_set_gain_curve_recorder(engine, &Writer::record, this);
+    }
+
+    void Writer::record(void* context, const float* frames, int numSamples)
+    {
+        auto& writer = *static_cast<Writer*>(context);
+        const size_t frameSize = writer.header.frameSize;
+
+        writer.encoded.clear();
+
+        for (size_t i = 0; i < static_cast<size_t>(numSamples) * frameSize; ++i)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, frames + i, sizeof(bits));
+
+            // Zigzag the wrapped miss so small misses either way stay small
+            std::uint32_t* last = writer.history.data() + 2 * (i % frameSize);
+            const std::uint32_t delta = bits - predict(last);
+            std::uint32_t zigzag = (delta << 1) ^ (0u - (delta >> 31));
+            last[1] = last[0];
+            last[0] = bits;
+
+            for (; zigzag >= 0x80u; zigzag >>= 7)
+                writer.encoded.push_back(static_cast<std::uint8_t>(zigzag | 0x80u));
+            writer.encoded.push_back(static_cast<std::uint8_t>(zigzag));
+        }
+
+        if (writer.file == nullptr || std::fwrite(writer.encoded.data(), 1, writer.encoded.size(), writer.file) != writer.encoded.size())
+        {
+            writer.failed = true;
+            return;
+        }
+
+        writer.header.numFrames += static_cast<std::uint64_t>(numSamples);
+    }
+
+    //==============================================================================
+    bool Reader::open(const std::string& path, double sampleRate, int numChannels, const mixcomp_params& params, std::string& error)
+    {
+        close();
+
+        file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+
+        std::uint8_t fixed[36];
+        std::string paramsText;
+        bool valid = std::fread(fixed, sizeof(fixed), 1, file) == 1 && std::memcmp(fixed, magic, sizeof(magic)) == 0
+                  && getLittleEndian(fixed + 4, 4) == version;
+
+        if (valid)
+        {
+            const std::uint64_t rateBits = getLittleEndian(fixed + 16, 8);
+            header.numChannels = static_cast<std::uint32_t>(getLittleEndian(fixed + 8, 4));
+            header.frameSize = static_cast<std::uint32_t>(getLittleEndian(fixed + 12, 4));
+            std::memcpy(&header.sampleRate, &rateBits, sizeof(rateBits));
+            header.numFrames = getLittleEndian(fixed + 24, 8);
+
+            const auto paramsLength = static_cast<std::uint32_t>(getLittleEndian(fixed + 32, 4));
+            paramsText.resize(paramsLength);
+            valid = paramsLength <= maxParamsLength && std::fread(&paramsText[0], 1, paramsLength, file) == paramsLength
+                 && parseParameters(paramsText, header.params)
+                 && header.frameSize == static_cast<std::uint32_t>(mixcomp_gain_curve_frame_size(numChannels, header.params.dual_stage));
+        }
+
+        if (!valid)
+            error = path + " is not a gain-curve file this build can read";
+        else if (header.sampleRate != sampleRate || header.numChannels != static_cast<std::uint32_t>(numChannels))
+            error = path + " was recorded at another sample rate or channel count";
+        else if (!mixcomp_same_gain_curve(&header.params, &params))
+            error = path + " was recorded with different detector parameters (only makeup, mix, topology and the output stage may change)";
+        else
+        {
+            history.assign(2 * header.frameSize, 0);
+            buffer.resize(readBufferSize);
+            bufferPos = bufferEnd = 0;
+            return true;
+        }
+
+        close();
+        return false;
+    }
+
+    void Reader::close()
+    {
+        if (file != nullptr)
+            std::fclose(file);
+
+        file = nullptr;
+    }
+
+    void Reader::attach(mixcomp_engine* engine)
+    {
+        mixcomp_set_gain_curve_player(engine, &Reader::play, this);
+    }
+
+    bool Reader::readVarint(std::uint32_t& value)
+    {
+        value = 0;
+
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            if (bufferPos == bufferEnd)
+            {
+                bufferEnd = file != nullptr ? std::fread(buffer.data(), 1, buffer.size(), file) : 0;
+                bufferPos = 0;
+
+                if (bufferEnd == 0)
+                    return false;
+            }
+
+            const std::uint8_t byte = buffer[bufferPos++];
+            value |= static_cast<std::uint32_t>(byte & 0x7fu) << shift;
+
+            if ((byte & 0x80u) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    int Reader::play(void* context, float* frames, int numSamples)
+    {
+        auto& reader = *static_cast<Reader*>(context);
+        const size_t frameSize = reader.header.frameSize;
+
+        for (size_t i = 0; i < static_cast<size_t>(numSamples) * frameSize; ++i)
+        {
+            std::uint32_t zigzag;
+            if (!reader.readVarint(zigzag))
+                return 0;
+
+            std::uint32_t* last = reader.history.data() + 2 * (i % frameSize);
+            const std::uint32_t bits = predict(last) + ((zigzag >> 1) ^ (0u - (zigzag & 1u)));
+            last[1] = last[0];
+            last[0] = bits;
+            std::memcpy(frames + i, &bits, sizeof(bits));
+        }
+
+        return 1;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "mixcomp.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// Streaming gain-curve file for mixcomp_render --record_gains / --replay_gains, written and
+// read a sub-block at a time. Everything is little-endian:
+//
+//   "MCGC", u32 version, u32 channels, u32 frame size, f64 sample rate, u64 frames,
+//   u32 length and the parameters as "name value" lines (see ParamFields::toText),
+//   then the engine's gain-curve frames (see mixcomp_set_gain_curve_recorder).
+//
+// Each float of a frame is stored as the difference of its bit pattern from a straight-line
+// prediction off the same column's last two frames, zigzagged into a varint. Smoothed gains
+// change slowly and sit still outside compression, so most values take one or two bytes
+// instead of four (about a third of raw float32), and replay gets the exact bits back.
+// Stage 2 columns are only there for dual-stage renders.
+namespace GainCurveFile
+{
+    constexpr std::uint32_t version = 2;
+
+    struct Header
+    {
+        std::uint32_t numChannels = 0;
+        std::uint32_t frameSize = 0;
+        double sampleRate = 0.0;
+        std::uint64_t numFrames = 0;    // patched when the writer closes
+        mixcomp_params params = {};
+    };
+
+    class Writer
+    {
+    public:
+        ~Writer() { close(); }
+
+        bool open(const std::string& path, double sampleRate, int numChannels, const mixcomp_params& params, std::string& error);
+        bool close();
+
+        // Installs the writer as the engine's recorder
+        void attach(mixcomp_engine* engine);
+
+    private:
+        std::FILE* file = nullptr;
+        Header header;
+        std::vector<std::uint32_t> history;     // last two frames' bits, per column
+        std::vector<std::uint8_t> encoded;
+        bool failed = false;
+
+        static void record(void* context, const float* frames, int numSamples);
+    };
+
+    class Reader
+    {
+    public:
+        ~Reader() { close(); }
+
+        // Fails unless the recording matches the render's rate, channels and detector parameters
+        bool open(const std::string& path, double sampleRate, int numChannels, const mixcomp_params& params, std::string& error);
+        void close();
+
+        // Installs the reader as the engine's player
+        void attach(mixcomp_engine* engine);
+
+        std::uint64_t getNumFrames() const { return header.numFrames; }
+
+    private:
+        std::FILE* file = nullptr;
+        Header header;
+        std::vector<std::uint32_t> history;
+        std::vector<std::uint8_t> buffer;
+        size_t bufferPos = 0, bufferEnd = 0;
+
+        bool readVarint(std::uint32_t& value);
+        static int play(void* context, float* frames, int numSamples);
+    };
+}
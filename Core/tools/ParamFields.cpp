@@ -0,0 +1,107 @@
+#include "ParamFields.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    struct ParamField
+    {
+        const char* name;
+        float mixcomp_params::* floatField;
+        int mixcomp_params::* intField;
+    };
+
+    const ParamField paramFields[] =
+    {
+        { "topology",              nullptr,                                &mixcomp_params::topology },
+        { "sc_hpf_hz",             &mixcomp_params::sc_hpf_hz,             nullptr },
+        { "sc_eq_shape",           nullptr,                                &mixcomp_params::sc_eq_shape },
+        { "sc_eq_freq_hz",         &mixcomp_params::sc_eq_freq_hz,         nullptr },
+        { "sc_eq_gain_db",         &mixcomp_params::sc_eq_gain_db,         nullptr },
+        { "threshold1_db",         &mixcomp_params::threshold1_db,         nullptr },
+        { "ratio1",                &mixcomp_params::ratio1,                nullptr },
+        { "attack1_ms",            &mixcomp_params::attack1_ms,            nullptr },
+        { "release1_ms",           &mixcomp_params::release1_ms,           nullptr },
+        { "dual_stage",            nullptr,                                &mixcomp_params::dual_stage },
+        { "threshold2_db",         &mixcomp_params::threshold2_db,         nullptr },
+        { "ratio2",                &mixcomp_params::ratio2,                nullptr },
+        { "attack2_ms",            &mixcomp_params::attack2_ms,            nullptr },
+        { "release2_ms",           &mixcomp_params::release2_ms,           nullptr },
+        { "knee_db",               &mixcomp_params::knee_db,               nullptr },
+        { "makeup_db",             &mixcomp_params::makeup_db,             nullptr },
+        { "auto_makeup",           nullptr,                                &mixcomp_params::auto_makeup },
+        { "mix_percent",           &mixcomp_params::mix_percent,           nullptr },
+        { "detector_rate",         nullptr,                                &mixcomp_params::detector_rate },
+        { "link_mode",             nullptr,                                &mixcomp_params::link_mode },
+        { "adaptive_quality",      nullptr,                                &mixcomp_params::adaptive_quality },
+        { "cpu_budget_percent",    &mixcomp_params::cpu_budget_percent,    nullptr },
+        { "true_peak_detect",      nullptr,                                &mixcomp_params::true_peak_detect },
+        { "double_precision",      nullptr,                                &mixcomp_params::double_precision },
+        { "upward_threshold_db",   &mixcomp_params::upward_threshold_db,   nullptr },
+        { "upward_ratio",          &mixcomp_params::upward_ratio,          nullptr },
+        { "expander_threshold_db", &mixcomp_params::expander_threshold_db, nullptr },
+        { "expander_ratio",        &mixcomp_params::expander_ratio,        nullptr },
+        { "expander_range_db",     &mixcomp_params::expander_range_db,     nullptr },
+        { "output_limiter",        nullptr,                                &mixcomp_params::output_limiter },
+        { "limiter_ceiling_db",    &mixcomp_params::limiter_ceiling_db,    nullptr },
+        { "limiter_release_ms",    &mixcomp_params::limiter_release_ms,    nullptr },
+    };
+}
+
+namespace ParamFields
+{
+    bool set(mixcomp_params& params, const char* name, const char* value)
+    {
+        for (auto& field : paramFields)
+        {
+            if (std::strcmp(field.name, name) != 0)
+                continue;
+
+            if (field.floatField != nullptr)
+                params.*field.floatField = static_cast<float>(std::atof(value));
+            else
+                params.*field.intField = std::atoi(value);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    void printNames(std::FILE* out)
+    {
+        for (auto& field : paramFields)
+            std::fprintf(out, " %s", field.name);
+        std::fprintf(out, "\n");
+    }
+
+    void print(std::FILE* out, const mixcomp_params& params)
+    {
+        for (auto& field : paramFields)
+        {
+            if (field.floatField != nullptr)
+                std::fprintf(out, "%-22s %g\n", field.name, params.*field.floatField);
+            else
+                std::fprintf(out, "%-22s %d\n", field.name, params.*field.intField);
+        }
+    }
+
+    std::string toText(const mixcomp_params& params)
+    {
+        std::string text;
+        char line[64];
+
+        for (auto& field : paramFields)
+        {
+            if (field.floatField != nullptr)
+                std::snprintf(line, sizeof(line), "%s %.9g\n", field.name, static_cast<double>(params.*field.floatField));
+            else
+                std::snprintf(line, sizeof(line), "%s %d\n", field.name, params.*field.intField);
+
+            text += line;
+        }
+
+        return text;
+    }
+}
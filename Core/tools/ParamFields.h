@@ -0,0 +1,23 @@
+#pragma once
+
+#include "mixcomp.h"
+
+#include <cstdio>
+#include <string>
+
+//==============================================================================
+// mixcomp_params fields by their C API names, for the tools' --<param> value options
+namespace ParamFields
+{
+    // False for an unknown name; values parse like atof / atoi
+    bool set(mixcomp_params& params, const char* name, const char* value);
+
+    // Space-separated list of every name
+    void printNames(std::FILE* out);
+
+    // One "name value" line per field
+    void print(std::FILE* out, const mixcomp_params& params);
+
+    // The same lines with floats to 9 significant digits, which set() reads back exactly
+    std::string toText(const mixcomp_params& params);
+}
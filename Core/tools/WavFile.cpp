@@ -0,0 +1,156 @@
+#include "WavFile.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    uint32_t readLE32(const unsigned char* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24); }
+    uint16_t readLE16(const unsigned char* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+    void writeLE32(std::ofstream& out, uint32_t v)
+    {
+        const unsigned char b[4] = { static_cast<unsigned char>(v), static_cast<unsigned char>(v >> 8),
+                                     static_cast<unsigned char>(v >> 16), static_cast<unsigned char>(v >> 24) };
+        out.write(reinterpret_cast<const char*>(b), 4);
+    }
+
+    void writeLE16(std::ofstream& out, uint16_t v)
+    {
+        const unsigned char b[2] = { static_cast<unsigned char>(v), static_cast<unsigned char>(v >> 8) };
+        out.write(reinterpret_cast<const char*>(b), 2);
+    }
+}
+
+bool WavFile::read(const std::string& path, std::string& error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 || std::memcmp(data.data() + 8, "WAVE", 4) != 0)
+    {
+        error = path + " is not a WAV file";
+        return false;
+    }
+
+    int format = 0, numChannels = 0, bitsPerSample = 0;
+    const unsigned char* samples = nullptr;
+    size_t sampleBytes = 0;
+
+    for (size_t pos = 12; pos + 8 <= data.size();)
+    {
+        const uint32_t chunkSize = readLE32(&data[pos + 4]);
+        const unsigned char* body = &data[pos + 8];
+        const size_t available = data.size() - (pos + 8);
+
+        if (std::memcmp(&data[pos], "fmt ", 4) == 0 && chunkSize >= 16 && available >= 16)
+        {
+            format = readLE16(body);
+            numChannels = readLE16(body + 2);
+            sampleRate = readLE32(body + 4);
+            bitsPerSample = readLE16(body + 14);
+
+            if (format == 0xfffe && chunkSize >= 26)    // WAVE_FORMAT_EXTENSIBLE: sub-format GUID
+                format = readLE16(body + 24);
+        }
+        else if (std::memcmp(&data[pos], "data", 4) == 0)
+        {
+            samples = body;
+            sampleBytes = chunkSize < available ? chunkSize : available;
+        }
+
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    const bool pcm = format == 1 && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+    const bool ieee = format == 3 && bitsPerSample == 32;
+
+    if (samples == nullptr || numChannels <= 0 || !(pcm || ieee))
+    {
+        error = path + ": unsupported WAV format (16/24/32-bit PCM or 32-bit float only)";
+        return false;
+    }
+
+    const int bytesPerSample = bitsPerSample / 8;
+    const size_t numFrames = sampleBytes / (static_cast<size_t>(bytesPerSample) * numChannels);
+    channels.assign(numChannels, std::vector<float>(numFrames));
+
+    for (size_t frame = 0; frame < numFrames; ++frame)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const unsigned char* p = samples + (frame * numChannels + ch) * bytesPerSample;
+            float value;
+
+            if (ieee)
+            {
+                const uint32_t bits = readLE32(p);
+                std::memcpy(&value, &bits, sizeof(value));
+            }
+            else if (bitsPerSample == 16)
+                value = static_cast<int16_t>(readLE16(p)) / 32768.0f;
+            else if (bitsPerSample == 24)
+                value = static_cast<float>(static_cast<int32_t>((p[0] << 8) | (p[1] << 16) | (static_cast<uint32_t>(p[2]) << 24)) >> 8) / 8388608.0f;
+            else
+                value = static_cast<float>(static_cast<int32_t>(readLE32(p)) / 2147483648.0);
+
+            channels[ch][frame] = value;
+        }
+    }
+
+    return true;
+}
+
+bool WavFile::write(const std::string& path, std::string& error) const
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+    {
+        error = "cannot create " + path;
+        return false;
+    }
+
+    const uint32_t numChannels = static_cast<uint32_t>(getNumChannels());
+    const uint32_t numFrames = static_cast<uint32_t>(getNumSamples());
+    const uint32_t dataBytes = numFrames * numChannels * 4;
+
+    out.write("RIFF", 4);
+    writeLE32(out, 36 + dataBytes);
+    out.write("WAVE", 4);
+
+    out.write("fmt ", 4);
+    writeLE32(out, 16);
+    writeLE16(out, 3);                                      // IEEE float
+    writeLE16(out, static_cast<uint16_t>(numChannels));
+    writeLE32(out, static_cast<uint32_t>(sampleRate));
+    writeLE32(out, static_cast<uint32_t>(sampleRate) * numChannels * 4);
+    writeLE16(out, static_cast<uint16_t>(numChannels * 4));
+    writeLE16(out, 32);
+
+    out.write("data", 4);
+    writeLE32(out, dataBytes);
+
+    for (uint32_t frame = 0; frame < numFrames; ++frame)
+    {
+        for (uint32_t ch = 0; ch < numChannels; ++ch)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &channels[ch][frame], sizeof(bits));
+            writeLE32(out, bits);
+        }
+    }
+
+    if (!out)
+    {
+        error = "failed writing " + path;
+        return false;
+    }
+
+    return true;
+}
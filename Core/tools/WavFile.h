@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//==============================================================================
+// Minimal RIFF/WAVE reader and writer for the command-line tools: 16/24/32-bit PCM
+// and 32-bit float in, 32-bit float out. Audio is held planar.
+struct WavFile
+{
+    double sampleRate = 44100.0;
+    std::vector<std::vector<float>> channels;
+
+    int getNumChannels() const { return static_cast<int>(channels.size()); }
+    int getNumSamples() const { return channels.empty() ? 0 : static_cast<int>(channels[0].size()); }
+
+    // Return false and fill error on failure
+    bool read(const std::string& path, std::string& error);
+    bool write(const std::string& path, std::string& error) const;
+};
@@ -0,0 +1,422 @@
+// Engine benchmark and regression checks, no audio files needed.
+//
+//   mixcomp_bench [--seconds S] [--rate HZ] [--trace out.json] [--offline 1]
+//
+// For every kernel variant this machine runs: realtime factor, then a null test against
+// the baseline variant, a check that the automatic choice is no slower than the baseline,
+// a block-size invariance check, a dual-mono check against a mono render, offline renders
+// (mixcomp_process_offline) against streaming ones, the chunked envelope scan against the
+// envelope kernel and a parameter sweep whose lanes are checked against engine renders. All
+// must be bit-exact (the sweep's curve tables only close), and the exact sweep must beat
+// rendering its variants one by one; the exit code is non-zero when any fails.
+// --trace records a Chrome trace of the first variant's timed run (tracing adds overhead to
+// that run's figure). --offline 1 only times mixcomp_process_offline against streaming
+// renders, at 1, 2, 4... threads up to the hardware's, best of three runs each (a thread
+// takes part in the chunked scan per 2^19 samples, about 11 s at 48 kHz).
+
+#include "mixcomp.h"
+#include "../DSPKernels.h"
+#include "../EnvelopeScan.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Planar = std::vector<std::vector<float>>;
+
+    // Deterministic programme material: decaying noise bursts over a low sine, with a
+    // level jump halfway so both stages, the knee and the makeup ramp all get exercised
+    Planar makeTestSignal(double sampleRate, int numSamples)
+    {
+        Planar signal(2, std::vector<float>(numSamples));
+        uint32_t seed = 0x12345678u;
+        const double pi = 3.14159265358979323846;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double t = i / sampleRate;
+            const double burst = std::exp(-std::fmod(t, 0.25) * 20.0);
+            const double level = i < numSamples / 2 ? 0.3 : 0.9;
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                const double noise = (static_cast<int32_t>(seed) / 2147483648.0);
+                const double tone = std::sin(2.0 * pi * (ch == 0 ? 110.0 : 113.0) * t);
+                signal[ch][i] = static_cast<float>(level * (0.6 * burst * noise + 0.3 * tone));
+            }
+        }
+
+        return signal;
+    }
+
+    // offlineThreads >= 0 renders the whole buffer in one mixcomp_process_offline call
+    Planar render(const Planar& input, double sampleRate, const char* kernels, int blockSize,
+                  const mixcomp_params& params, double* secondsTaken = nullptr, int offlineThreads = -1)
+    {
+        Planar output = input;
+        const int numChannels = static_cast<int>(output.size());
+        const int numSamples = static_cast<int>(output[0].size());
+
+        mixcomp_engine* engine = mixcomp_create();
+        mixcomp_set_kernel_variant(engine, kernels);
+        mixcomp_prepare(engine, sampleRate, numChannels);
+        mixcomp_set_params(engine, &params);
+
+        std::vector<float*> block(numChannels);
+        const auto start = std::chrono::steady_clock::now();
+
+        if (offlineThreads >= 0)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                block[ch] = output[ch].data();
+
+            mixcomp_process_offline(engine, block.data(), numChannels, numSamples, offlineThreads);
+        }
+
+        for (int pos = 0; offlineThreads < 0 && pos < numSamples; pos += blockSize)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                block[ch] = output[ch].data() + pos;
+
+            mixcomp_process(engine, block.data(), numChannels, std::min(blockSize, numSamples - pos));
+        }
+
+        if (secondsTaken != nullptr)
+            *secondsTaken = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        mixcomp_destroy(engine);
+        return output;
+    }
+
+    // Every variant through one sweep in 512-sample blocks; lanes (optional) gets the audio
+    void sweep(const Planar& input, double sampleRate, const std::vector<mixcomp_params>& variants, bool curveTables,
+               std::vector<Planar>* lanes, std::vector<mixcomp_sweep_stats>& stats, double* secondsTaken)
+    {
+        const int numChannels = static_cast<int>(input.size());
+        const int numSamples = static_cast<int>(input[0].size());
+        const int numVariants = static_cast<int>(variants.size());
+
+        if (lanes != nullptr)
+            lanes->assign(numVariants, Planar(numChannels, std::vector<float>(numSamples)));
+
+        std::vector<const float*> inputs(numChannels);
+        std::vector<float*> outputs(numVariants * numChannels);
+
+        mixcomp_sweep* sweeper = mixcomp_sweep_create();
+        mixcomp_sweep_set_curve_tables(sweeper, curveTables ? 1 : 0);
+        mixcomp_sweep_prepare(sweeper, sampleRate, numChannels, variants.data(), numVariants);
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int pos = 0; pos < numSamples; pos += 512)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                inputs[ch] = input[ch].data() + pos;
+
+                if (lanes != nullptr)
+                    for (int v = 0; v < numVariants; ++v)
+                        outputs[v * numChannels + ch] = (*lanes)[v][ch].data() + pos;
+            }
+
+            mixcomp_sweep_process(sweeper, inputs.data(), lanes != nullptr ? outputs.data() : nullptr,
+                                  std::min(512, numSamples - pos));
+        }
+
+        *secondsTaken = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        stats.resize(numVariants);
+        for (int v = 0; v < numVariants; ++v)
+            mixcomp_sweep_get_stats(sweeper, v, &stats[v]);
+
+        mixcomp_sweep_destroy(sweeper);
+    }
+
+    bool identical(const Planar& a, const Planar& b)
+    {
+        for (size_t ch = 0; ch < a.size(); ++ch)
+            if (std::memcmp(a[ch].data(), b[ch].data(), a[ch].size() * sizeof(float)) != 0)
+                return false;
+
+        return true;
+    }
+
+    // Best of three timed renders
+    double bestOfThree(const Planar& input, double sampleRate, const mixcomp_params& params, int offlineThreads,
+                       Planar& output)
+    {
+        double best = 1e9;
+
+        for (int run = 0; run < 3; ++run)
+        {
+            double taken = 0.0;
+            output = render(input, sampleRate, nullptr, 512, params, &taken, offlineThreads);
+            best = std::min(best, taken);
+        }
+
+        return best;
+    }
+
+    // --offline: offline against streaming renders per thread count
+    int benchOffline(const Planar& input, double sampleRate, double seconds, const mixcomp_params& params)
+    {
+        const int hardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        const int numSamples = static_cast<int>(input[0].size());
+        bool ok = true;
+
+        std::printf("offline, %.0f s at %.0f Hz, %d hardware threads, chunked scan from %d threads and %lld samples\n",
+                    seconds, sampleRate, hardwareThreads, 2,
+                    static_cast<long long>(2 * EnvelopeScan::minChunkSamples * DSPKernels::numEnvelopeLanes));
+
+        for (float releaseMs : { 150.0f, 1000.0f })
+        {
+            mixcomp_params offlineParams = params;
+            offlineParams.release1_ms = releaseMs;
+
+            Planar streaming, offline;
+            const double streamingTaken = bestOfThree(input, sampleRate, offlineParams, -1, streaming);
+
+            for (int threads = 1; threads <= hardwareThreads; threads *= 2)
+            {
+                const double taken = bestOfThree(input, sampleRate, offlineParams, threads, offline);
+                const bool exact = identical(offline, streaming);
+                ok = ok && exact;
+
+                std::printf("release %4.0f ms  %2d threads  %6.1fx realtime  %.2fx vs streaming (%s): %s\n", releaseMs,
+                            threads, seconds / taken, streamingTaken / taken,
+                            EnvelopeScan::getUsefulThreads(numSamples, threads) >= 2 ? "chunked" : "streams",
+                            exact ? "bit-exact" : "FAILED");
+            }
+        }
+
+        return ok ? 0 : 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 30.0, sampleRate = 48000.0;
+    const char* tracePath = nullptr;
+    bool offlineOnly = false;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--seconds") == 0)
+            seconds = std::max(1.0, std::atof(argv[i + 1]));
+        else if (std::strcmp(argv[i], "--rate") == 0)
+            sampleRate = std::max(8000.0, std::atof(argv[i + 1]));
+        else if (std::strcmp(argv[i], "--trace") == 0)
+            tracePath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--offline") == 0)
+            offlineOnly = std::atoi(argv[i + 1]) != 0;
+    }
+
+    const int numSamples = static_cast<int>(seconds * sampleRate);
+    const Planar input = makeTestSignal(sampleRate, numSamples);
+
+    mixcomp_params params;
+    mixcomp_default_params(&params);
+    params.threshold1_db = -20.0f;
+    params.dual_stage = 1;
+    params.sc_eq_shape = MIXCOMP_SC_EQ_TILT;
+    params.sc_eq_gain_db = 4.0f;
+
+    if (offlineOnly)
+    {
+        params.detector_rate = MIXCOMP_DETECTOR_AUDIO_RATE;
+        return benchOffline(input, sampleRate, seconds, params);
+    }
+
+    const char* variants[] = { "generic", "sse2", "neon", "avx2", "avx512" };
+    const char* baseline = nullptr;
+    Planar reference;
+    bool ok = true;
+
+    for (const char* variant : variants)
+    {
+        // Only variants this build and CPU can run
+        mixcomp_engine* probe = mixcomp_create();
+        const bool available = mixcomp_set_kernel_variant(probe, variant) == MIXCOMP_OK;
+        mixcomp_destroy(probe);
+
+        if (!available)
+            continue;
+
+        const bool tracing = baseline == nullptr && tracePath != nullptr;
+        if (tracing && mixcomp_trace_begin(tracePath) != MIXCOMP_OK)
+        {
+            std::fprintf(stderr, "cannot trace to '%s' (tracing compiled out, or unwritable path)\n", tracePath);
+            return 1;
+        }
+
+        double taken = 0.0;
+        const Planar output = render(input, sampleRate, variant, 512, params, &taken);
+
+        if (tracing)
+            std::printf("trace: %s (%llu events dropped)\n", tracePath, mixcomp_trace_end());
+
+        if (baseline == nullptr)
+        {
+            baseline = variant;
+            reference = output;
+        }
+
+        const bool nullTest = identical(output, reference);
+        ok = ok && nullTest;
+
+        std::printf("%-8s %8.1fx realtime  %7.3f ms/s  null vs %s: %s\n", variant, seconds / taken,
+                    taken * 1000.0 / seconds, baseline, nullTest ? "bit-exact" : "FAILED");
+    }
+
+    // Automatic choice must not lose to the baseline: best of five alternating runs each,
+    // with 5% allowed for timing noise (choosing the baseline itself always passes)
+    {
+        mixcomp_engine* probe = mixcomp_create();
+        mixcomp_prepare(probe, sampleRate, 2);
+        const char* chosen = mixcomp_get_kernel_variant(probe);
+        mixcomp_destroy(probe);
+
+        double autoBest = 1e9, baselineBest = 1e9;
+        for (int run = 0; run < 5; ++run)
+        {
+            double taken = 0.0;
+            render(input, sampleRate, nullptr, 512, params, &taken);
+            autoBest = std::min(autoBest, taken);
+            render(input, sampleRate, baseline, 512, params, &taken);
+            baselineBest = std::min(baselineBest, taken);
+        }
+
+        const bool fastEnough = std::strcmp(chosen, baseline) == 0 || autoBest <= baselineBest * 1.05;
+        ok = ok && fastEnough;
+        std::printf("auto (%s) %6.1fx realtime vs %s %.1fx: %s\n", chosen, seconds / autoBest, baseline,
+                    seconds / baselineBest, fastEnough ? "ok" : "FAILED (slower than the baseline)");
+    }
+
+    // The output must not depend on how the host slices the stream
+    for (int blockSize : { 1, 7, 32, 100, 4096 })
+    {
+        const bool invariant = identical(render(input, sampleRate, baseline, blockSize, params), reference);
+        ok = ok && invariant;
+        std::printf("block %-5d vs 512: %s\n", blockSize, invariant ? "bit-exact" : "FAILED");
+    }
+
+    // Dual mono takes the one-channel fast path; each channel must match a mono render
+    {
+        const Planar monoInput(1, input[0]);
+        const Planar dualInput(2, input[0]);
+
+        double taken = 0.0;
+        const Planar dual = render(dualInput, sampleRate, baseline, 512, params, &taken);
+        const Planar mono = render(monoInput, sampleRate, baseline, 512, params);
+        const bool exact = identical(Planar(1, dual[0]), mono) && identical(Planar(1, dual[1]), mono);
+        ok = ok && exact;
+
+        std::printf("dual mono %6.1fx realtime  %7.3f ms/s  vs mono: %s\n", seconds / taken,
+                    taken * 1000.0 / seconds, exact ? "bit-exact" : "FAILED");
+    }
+
+    // Offline renders: audio-rate detectors, fast and slow ballistics, on all threads (they
+    // stream on one core or a short buffer). The chunked envelope scan itself also runs on two
+    // threads over a stream long enough for it, so it is checked on any machine.
+    {
+        mixcomp_params offlineParams = params;
+        offlineParams.detector_rate = MIXCOMP_DETECTOR_AUDIO_RATE;
+
+        const auto& kernels = DSPKernels::getKernels(DSPKernels::getPreferredVariant());
+        const std::int64_t scanLength = 4 * EnvelopeScan::minChunkSamples * DSPKernels::numEnvelopeLanes;
+        std::vector<float> sc(static_cast<size_t>(scanLength)), scanned(sc.size()), direct(sc.size());
+
+        for (size_t i = 0; i < sc.size(); ++i)
+            sc[i] = input[0][i % input[0].size()];
+
+        for (float releaseMs : { 150.0f, 1000.0f })
+        {
+            offlineParams.release1_ms = releaseMs;
+
+            const Planar streaming = render(input, sampleRate, baseline, 512, offlineParams);
+            const bool exact = identical(render(input, sampleRate, baseline, 512, offlineParams, nullptr, 0), streaming);
+
+            const float attackCoef = static_cast<float>(1.0 - std::exp(-1000.0 / (offlineParams.attack1_ms * sampleRate)));
+            const float releaseCoef = static_cast<float>(1.0 - std::exp(-1000.0 / (releaseMs * sampleRate)));
+            const float directEnd = kernels.envelope(sc.data(), direct.data(), static_cast<int>(scanLength), 0.0f,
+                                                     attackCoef, releaseCoef);
+            const float scannedEnd = EnvelopeScan::process(kernels, sc.data(), scanned.data(), scanLength, 0.0f,
+                                                           attackCoef, releaseCoef, 2);
+            const bool scanExact = directEnd == scannedEnd
+                                && std::memcmp(scanned.data(), direct.data(), direct.size() * sizeof(float)) == 0;
+            ok = ok && exact && scanExact;
+
+            std::printf("offline release %4.0f ms  all threads (%s) vs streaming: %s, scan on 2 threads: %s\n", releaseMs,
+                        EnvelopeScan::getUsefulThreads(numSamples, 0) >= 2 ? "chunked" : "streams",
+                        exact ? "bit-exact" : "FAILED", scanExact ? "bit-exact" : "FAILED");
+        }
+    }
+
+    // Sweep: each lane must match an audio-rate engine render of its variant; the curve
+    // tables only have to land close to the exact statistics
+    {
+        constexpr int numVariants = 8;
+        std::vector<mixcomp_params> variantParams(numVariants);
+
+        for (int v = 0; v < numVariants; ++v)
+        {
+            auto& p = variantParams[v];
+            p = params;
+            p.detector_rate = MIXCOMP_DETECTOR_AUDIO_RATE;
+            p.threshold1_db = -30.0f + 2.0f * v;
+            p.ratio1 = 2.0f + 0.5f * v;
+            p.attack1_ms = 2.0f + 4.0f * v;
+            p.release1_ms = 60.0f + 30.0f * v;
+            p.threshold2_db = -14.0f + v;
+            p.knee_db = static_cast<float>((v % 3) * 4);
+            p.auto_makeup = v % 2;
+            p.makeup_db = static_cast<float>(v);
+            p.mix_percent = 100.0f - 8.0f * v;
+            p.expander_ratio = v == 5 ? 3.0f : 1.0f;
+        }
+
+        std::vector<Planar> lanes;
+        std::vector<mixcomp_sweep_stats> exactStats, tableStats;
+        double taken = 0.0, tableTaken = 0.0;
+        sweep(input, sampleRate, variantParams, false, &lanes, exactStats, &taken);
+        sweep(input, sampleRate, variantParams, true, nullptr, tableStats, &tableTaken);
+
+        double separate = 0.0;
+        bool exact = true;
+
+        for (int v = 0; v < numVariants; ++v)
+        {
+            double renderTaken = 0.0;
+            exact = identical(render(input, sampleRate, nullptr, 512, variantParams[v], &renderTaken), lanes[v]) && exact;
+            separate += renderTaken;
+        }
+
+        float loudnessError = 0.0f, grError = 0.0f;
+        for (int v = 0; v < numVariants; ++v)
+        {
+            loudnessError = std::max(loudnessError, std::fabs(tableStats[v].loudness_lufs - exactStats[v].loudness_lufs));
+            grError = std::max(grError, std::fabs(tableStats[v].gr_mean_db - exactStats[v].gr_mean_db));
+        }
+
+        const bool close = loudnessError < 0.05f && grError < 0.05f;
+        const bool faster = taken < separate;
+        ok = ok && exact && close && faster;
+
+        std::printf("sweep x%d exact   %6.1fx realtime  %7.3f ms/s  %.2fx vs renders%s, vs engine: %s\n", numVariants,
+                    seconds / taken, taken * 1000.0 / seconds, separate / taken, faster ? "" : " (FAILED: slower)",
+                    exact ? "bit-exact" : "FAILED");
+        std::printf("sweep x%d tables  %6.1fx realtime  %7.3f ms/s  %.2fx vs renders, stats within %.3f LU / %.3f dB GR: %s\n",
+                    numVariants, seconds / tableTaken, tableTaken * 1000.0 / seconds, separate / tableTaken, loudnessError, grError,
+                    close ? "ok" : "FAILED");
+    }
+
+    return ok ? 0 : 1;
+}
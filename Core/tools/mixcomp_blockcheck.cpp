@@ -0,0 +1,199 @@
+// Block-size invariance check: renders the same material through a handful of parameter
+// sets at many host buffer sizes, and at sizes varying call by call, and compares every
+// render and the meters it ends on with a 128-sample render bit for bit. Registered as a
+// CTest test; the exit code is non-zero when anything differs.
+//
+//   mixcomp_blockcheck [--seconds S] [--rate HZ]
+
+#include "mixcomp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+    using Planar = std::vector<std::vector<float>>;
+
+    constexpr int referenceBlockSize = 128;
+    constexpr int varyingBlockSizes = -1;
+
+    struct Render
+    {
+        Planar audio;
+        mixcomp_meters meters;
+    };
+
+    // Noise bursts over a sine in a level staircase, so auto makeup, the meters and both
+    // detectors keep moving across the whole render
+    Planar makeTestSignal(double sampleRate, int numSamples)
+    {
+        Planar signal(2, std::vector<float>(numSamples));
+        uint32_t seed = 0x2468aceu;
+        const double pi = 3.14159265358979323846;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double t = i / sampleRate;
+            const double burst = std::exp(-std::fmod(t, 0.3) * 12.0);
+            const double level = 0.1 + 0.25 * static_cast<double>((i * 4 / numSamples) % 4);
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                const double noise = static_cast<int32_t>(seed) / 2147483648.0;
+                const double tone = std::sin(2.0 * pi * (ch == 0 ? 220.0 : 223.0) * t);
+                signal[ch][i] = static_cast<float>(level * (0.7 * burst * noise + 0.3 * tone));
+            }
+        }
+
+        return signal;
+    }
+
+    // blockSize varyingBlockSizes cycles through odd sizes from 1 to 2048, as some hosts do
+    Render render(const Planar& input, double sampleRate, const mixcomp_params& params, int blockSize)
+    {
+        static const int varying[] = { 1, 2048, 17, 333, 64, 1000, 3, 511, 128, 1499 };
+
+        Render result{ input, {} };
+        const int numChannels = static_cast<int>(input.size());
+        const int numSamples = static_cast<int>(input[0].size());
+
+        mixcomp_engine* engine = mixcomp_create();
+        mixcomp_prepare(engine, sampleRate, numChannels);
+        mixcomp_set_params(engine, &params);
+
+        std::vector<float*> block(numChannels);
+
+        for (int pos = 0, call = 0; pos < numSamples; ++call)
+        {
+            const int size = blockSize == varyingBlockSizes ? varying[call % std::size(varying)] : blockSize;
+            const int numThisTime = std::min(size, numSamples - pos);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                block[ch] = result.audio[ch].data() + pos;
+
+            mixcomp_process(engine, block.data(), numChannels, numThisTime);
+            pos += numThisTime;
+        }
+
+        mixcomp_get_meters(engine, &result.meters);
+        mixcomp_destroy(engine);
+        return result;
+    }
+
+    bool identical(const Render& a, const Render& b)
+    {
+        for (size_t ch = 0; ch < a.audio.size(); ++ch)
+            if (std::memcmp(a.audio[ch].data(), b.audio[ch].data(), a.audio[ch].size() * sizeof(float)) != 0)
+                return false;
+
+        // The audio meters; cpu_load measures the machine
+        return std::memcmp(&a.meters.gain_reduction_db, &b.meters.gain_reduction_db, sizeof(float)) == 0
+            && std::memcmp(&a.meters.input_rms, &b.meters.input_rms, sizeof(float)) == 0
+            && std::memcmp(&a.meters.output_rms, &b.meters.output_rms, sizeof(float)) == 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 4.0, sampleRate = 48000.0;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--seconds") == 0)
+            seconds = std::max(0.1, std::atof(argv[i + 1]));
+        else if (std::strcmp(argv[i], "--rate") == 0)
+            sampleRate = std::max(8000.0, std::atof(argv[i + 1]));
+        else
+        {
+            std::fprintf(stderr, "usage: mixcomp_blockcheck [--seconds S] [--rate HZ]\n");
+            return 2;
+        }
+    }
+
+    const Planar input = makeTestSignal(sampleRate, static_cast<int>(seconds * sampleRate));
+
+    struct Case
+    {
+        const char* name;
+        mixcomp_params params;
+    };
+
+    std::vector<Case> cases;
+    auto addCase = [&cases](const char* name) -> mixcomp_params&
+    {
+        cases.push_back({ name, {} });
+        mixcomp_default_params(&cases.back().params);
+        return cases.back().params;
+    };
+
+    addCase("defaults");
+
+    {
+        auto& p = addCase("dual stage, auto makeup, tilt EQ");
+        p.threshold1_db = -24.0f;
+        p.dual_stage = 1;
+        p.auto_makeup = 1;
+        p.mix_percent = 70.0f;
+        p.sc_eq_shape = MIXCOMP_SC_EQ_TILT;
+        p.sc_eq_gain_db = 4.0f;
+    }
+    {
+        auto& p = addCase("control-rate detector, optical");
+        p.topology = MIXCOMP_TOPOLOGY_OPTICAL;
+        p.detector_rate = MIXCOMP_DETECTOR_AUTO;
+        p.attack1_ms = 40.0f;
+        p.release1_ms = 900.0f;
+        p.auto_makeup = 1;
+    }
+    {
+        auto& p = addCase("upward and expander, FET");
+        p.topology = MIXCOMP_TOPOLOGY_FET;
+        p.upward_threshold_db = -30.0f;
+        p.upward_ratio = 2.0f;
+        p.expander_threshold_db = -45.0f;
+        p.expander_ratio = 3.0f;
+        p.knee_db = 12.0f;
+    }
+    {
+        auto& p = addCase("limiter, true peak, double precision");
+        p.threshold1_db = -30.0f;
+        p.makeup_db = 12.0f;
+        p.true_peak_detect = 1;
+        p.double_precision = 1;
+        p.detector_rate = MIXCOMP_DETECTOR_AUDIO_RATE;
+        p.output_limiter = 1;
+        p.limiter_ceiling_db = -1.0f;
+    }
+
+    const int blockSizes[] = { 1, 7, 32, 100, 441, 512, 4096, 8192, varyingBlockSizes };
+    bool ok = true;
+
+    for (const auto& test : cases)
+    {
+        const Render reference = render(input, sampleRate, test.params, referenceBlockSize);
+        std::printf("%-38s", test.name);
+
+        for (int blockSize : blockSizes)
+        {
+            const bool invariant = identical(render(input, sampleRate, test.params, blockSize), reference);
+            ok = ok && invariant;
+
+            if (blockSize == varyingBlockSizes)
+                std::printf(" varying%s", invariant ? "" : " FAILED");
+            else
+                std::printf(" %d%s", blockSize, invariant ? "" : " FAILED");
+        }
+
+        std::printf("\n");
+    }
+
+    std::printf("vs %d-sample blocks: %s\n", referenceBlockSize, ok ? "bit-exact" : "FAILED");
+    return ok ? 0 : 1;
+}
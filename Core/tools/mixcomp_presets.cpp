@@ -0,0 +1,228 @@
+// Builds and searches preset libraries (the indexed, memory-mapped files the plugin browses).
+//
+//   mixcomp_presets build out.mcpl presets.txt
+//   mixcomp_presets list lib.mcpl [--name TEXT] [--tag NAME]... [--topology N]
+//   mixcomp_presets show lib.mcpl INDEX
+//
+// presets.txt holds one preset per line, "name | tag,tag,... | param=value,param=value,...",
+// with the parameters by their C API names on top of the defaults; blank lines and lines
+// starting with # are skipped. Tags name the instrument, style or anything else to filter
+// on (at most 64 per library). list prints matching entries with their index for show.
+
+#include "../PresetLibrary.h"
+#include "ParamFields.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    int usage()
+    {
+        std::fprintf(stderr, "usage: mixcomp_presets build out.mcpl presets.txt\n"
+                             "       mixcomp_presets list lib.mcpl [--name TEXT] [--tag NAME]... [--topology N]\n"
+                             "       mixcomp_presets show lib.mcpl INDEX\nparams:");
+        ParamFields::printNames(stderr);
+        return 2;
+    }
+
+    std::string trim(const std::string& text)
+    {
+        const size_t start = text.find_first_not_of(" \t\r");
+        if (start == std::string::npos)
+            return {};
+
+        return text.substr(start, text.find_last_not_of(" \t\r") - start + 1);
+    }
+
+    std::vector<std::string> split(const std::string& text, char separator)
+    {
+        std::vector<std::string> parts;
+        size_t start = 0;
+
+        for (;;)
+        {
+            const size_t end = text.find(separator, start);
+            parts.push_back(trim(text.substr(start, end - start)));
+
+            if (end == std::string::npos)
+                return parts;
+
+            start = end + 1;
+        }
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    int build(const char* outputPath, const char* specPath)
+    {
+        std::ifstream specs(specPath);
+        if (!specs)
+        {
+            std::fprintf(stderr, "cannot open %s\n", specPath);
+            return 1;
+        }
+
+        std::vector<PresetLibrary::Entry> entries;
+        std::string line;
+
+        for (int lineNumber = 1; std::getline(specs, line); ++lineNumber)
+        {
+            line = trim(line);
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            const auto fields = split(line, '|');
+            PresetLibrary::Entry entry;
+            entry.name = fields[0];
+            mixcomp_default_params(&entry.params);
+            bool valid = fields.size() <= 3;
+
+            if (valid && fields.size() > 1)
+                for (const auto& tag : split(fields[1], ','))
+                    if (!tag.empty())
+                        entry.tags.push_back(tag);
+
+            if (valid && fields.size() > 2 && !fields[2].empty())
+            {
+                for (const auto& assignment : split(fields[2], ','))
+                {
+                    const size_t equals = assignment.find('=');
+                    valid = valid && equals != std::string::npos
+                         && ParamFields::set(entry.params, trim(assignment.substr(0, equals)).c_str(),
+                                             trim(assignment.substr(equals + 1)).c_str());
+                }
+            }
+
+            if (!valid)
+            {
+                std::fprintf(stderr, "%s:%d: expected \"name | tags | param=value,...\"\n", specPath, lineNumber);
+                return 1;
+            }
+
+            entries.push_back(std::move(entry));
+        }
+
+        const size_t numEntries = entries.size();
+        std::string error;
+
+        if (!PresetLibrary::write(outputPath, std::move(entries), error))
+        {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+
+        std::printf("%zu presets written to %s\n", numEntries, outputPath);
+        return 0;
+    }
+
+    int list(const std::shared_ptr<const PresetLibrary>& library, int argc, char** argv)
+    {
+        PresetLibrary::Query query;
+
+        for (int i = 0; i < argc; ++i)
+        {
+            if (std::strncmp(argv[i], "--", 2) != 0 || i + 1 >= argc)
+                return usage();
+
+            const char* name = argv[i] + 2;
+            const char* value = argv[++i];
+
+            if (std::strcmp(name, "name") == 0)
+                query.nameContains = value;
+            else if (std::strcmp(name, "topology") == 0)
+                query.topology = std::atoi(value);
+            else if (std::strcmp(name, "tag") == 0)
+            {
+                const int tag = library->findTag(value);
+                if (tag < 0)
+                {
+                    std::fprintf(stderr, "no tag '%s' in this library\n", value);
+                    return 1;
+                }
+
+                query.requiredTags |= std::uint64_t(1) << tag;
+            }
+            else
+                return usage();
+        }
+
+        std::vector<int> matches;
+        const auto start = std::chrono::steady_clock::now();
+        library->search(query, matches);
+        const double searchMilliseconds = millisecondsSince(start);
+
+        static const char* topologyNames[] = { "VCA", "FET", "Optical" };
+
+        for (int entry : matches)
+        {
+            const auto name = library->getName(entry);
+            const int topology = library->getTopology(entry);
+            std::printf("%-7d %-*.*s %-8s", entry, PresetLibrary::maxNameLength, static_cast<int>(name.size()), name.data(),
+                        topology >= 0 && topology < 3 ? topologyNames[topology] : "?");
+
+            const char* separator = " ";
+            for (int tag = 0; tag < library->getNumTags(); ++tag)
+            {
+                if ((library->getTags(entry) >> tag & 1) == 0)
+                    continue;
+
+                const auto tagName = library->getTagName(tag);
+                std::printf("%s%.*s", separator, static_cast<int>(tagName.size()), tagName.data());
+                separator = ",";
+            }
+
+            std::printf("\n");
+        }
+
+        std::printf("%zu of %d presets (search %.3f ms)\n", matches.size(), library->getNumEntries(), searchMilliseconds);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+        return usage();
+
+    const std::string command = argv[1];
+
+    if (command == "build")
+        return argc == 4 ? build(argv[2], argv[3]) : usage();
+
+    if (command != "list" && command != "show")
+        return usage();
+
+    std::string error;
+    const auto start = std::chrono::steady_clock::now();
+    const auto library = PresetLibrary::open(argv[2], error);
+
+    if (library == nullptr)
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::printf("%s: %d presets, %d tags (opened in %.3f ms)\n", argv[2], library->getNumEntries(), library->getNumTags(),
+                millisecondsSince(start));
+
+    if (command == "list")
+        return list(library, argc - 3, argv + 3);
+
+    mixcomp_params params;
+    if (argc != 4 || !library->getParams(std::atoi(argv[3]), params))
+        return usage();
+
+    const auto name = library->getName(std::atoi(argv[3]));
+    std::printf("%.*s\n", static_cast<int>(name.size()), name.data());
+    ParamFields::print(stdout, params);
+    return 0;
+}
@@ -0,0 +1,198 @@
+// Headless renderer: runs a WAV file through the compressor engine via the C API.
+//
+//   mixcomp_render in.wav out.wav [--block N | --offline_threads N] [--kernels NAME] [--trace out.json]
+//                 [--record_gains out.mcg | --replay_gains in.mcg] [--<param> value ...]
+//
+// Parameters use the C API field names, e.g. --threshold1_db -18 --ratio1 3 --dual_stage 1
+// The engine's latency (output limiter look-ahead) is compensated: the file stays aligned.
+//
+// --record_gains saves the stages' gain curves while rendering; --replay_gains re-renders
+// from them without running the detectors, bit-identical to a full render as long as only
+// makeup, mix, topology or the output stage changed (anything else is refused).
+//
+// --offline_threads renders the file in one mixcomp_process_offline call on N threads
+// (0 = all cores); the output is the same.
+
+#include "mixcomp.h"
+#include "GainCurveFile.h"
+#include "ParamFields.h"
+#include "WavFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    int usage()
+    {
+        std::fprintf(stderr, "usage: mixcomp_render in.wav out.wav [--block N | --offline_threads N] [--kernels NAME]\n"
+                             "                      [--trace out.json] [--record_gains out.mcg | --replay_gains in.mcg] [--<param> value ...]\nparams:");
+        ParamFields::printNames(stderr);
+        return 2;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+        return usage();
+
+    const std::string inputPath = argv[1], outputPath = argv[2];
+    int blockSize = 512;
+    int offlineThreads = -1;
+    const char* kernels = nullptr;
+    const char* tracePath = nullptr;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+
+    mixcomp_params params;
+    mixcomp_default_params(&params);
+
+    for (int i = 3; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--", 2) != 0 || i + 1 >= argc)
+            return usage();
+
+        const char* name = argv[i] + 2;
+        const char* value = argv[++i];
+
+        if (std::strcmp(name, "block") == 0)
+            blockSize = std::max(1, std::atoi(value));
+        else if (std::strcmp(name, "offline_threads") == 0)
+            offlineThreads = std::max(0, std::atoi(value));
+        else if (std::strcmp(name, "kernels") == 0)
+            kernels = value;
+        else if (std::strcmp(name, "trace") == 0)
+            tracePath = value;
+        else if (std::strcmp(name, "record_gains") == 0)
+            recordPath = value;
+        else if (std::strcmp(name, "replay_gains") == 0)
+            replayPath = value;
+        else if (!ParamFields::set(params, name, value))
+        {
+            std::fprintf(stderr, "unknown option --%s\n", name);
+            return usage();
+        }
+    }
+
+    WavFile audio;
+    std::string error;
+    if (!audio.read(inputPath, error))
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    const int numChannels = std::min(audio.getNumChannels(), MIXCOMP_MAX_CHANNELS);
+    const int numSamples = audio.getNumSamples();
+
+    if (recordPath != nullptr && replayPath != nullptr)
+        return usage();
+
+    GainCurveFile::Writer gainWriter;
+    GainCurveFile::Reader gainReader;
+
+    if ((recordPath != nullptr && !gainWriter.open(recordPath, audio.sampleRate, numChannels, params, error))
+        || (replayPath != nullptr && !gainReader.open(replayPath, audio.sampleRate, numChannels, params, error)))
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    mixcomp_engine* engine = mixcomp_create();
+    if (kernels != nullptr && mixcomp_set_kernel_variant(engine, kernels) != MIXCOMP_OK)
+    {
+        std::fprintf(stderr, "kernel variant '%s' is not available\n", kernels);
+        mixcomp_destroy(engine);
+        return 1;
+    }
+
+    if (tracePath != nullptr && mixcomp_trace_begin(tracePath) != MIXCOMP_OK)
+    {
+        std::fprintf(stderr, "cannot trace to '%s' (tracing compiled out, or unwritable path)\n", tracePath);
+        mixcomp_destroy(engine);
+        return 1;
+    }
+
+    mixcomp_prepare(engine, audio.sampleRate, numChannels);
+    mixcomp_set_params(engine, &params);
+
+    if (recordPath != nullptr)
+        gainWriter.attach(engine);
+
+    if (replayPath != nullptr)
+        gainReader.attach(engine);
+
+    // Run the latency's worth of silence through after the file, then drop as much from the front.
+    // Recordings also cover the limiter's look-ahead, so any output stage can replay them.
+    const int latency = mixcomp_get_latency(engine);
+    int tail = latency;
+
+    if (recordPath != nullptr)
+    {
+        mixcomp_params limited = params;
+        limited.output_limiter = 1;
+        mixcomp_set_params(engine, &limited);
+        tail = std::max(tail, mixcomp_get_latency(engine));
+        mixcomp_set_params(engine, &params);
+    }
+
+    const int numRendered = numSamples + tail;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        audio.channels[ch].resize(static_cast<size_t>(numRendered), 0.0f);
+
+    std::vector<float*> block(numChannels);
+    if (offlineThreads >= 0)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            block[ch] = audio.channels[ch].data();
+
+        mixcomp_process_offline(engine, block.data(), numChannels, numRendered, offlineThreads);
+    }
+    else
+    {
+        for (int pos = 0; pos < numRendered; pos += blockSize)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                block[ch] = audio.channels[ch].data() + pos;
+
+            mixcomp_process(engine, block.data(), numChannels, std::min(blockSize, numRendered - pos));
+        }
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        audio.channels[ch].erase(audio.channels[ch].begin(), audio.channels[ch].begin() + latency);
+        audio.channels[ch].resize(static_cast<size_t>(numSamples));
+    }
+
+    if (tracePath != nullptr)
+        std::printf("trace: %s (%llu events dropped)\n", tracePath, mixcomp_trace_end());
+
+    mixcomp_meters meters;
+    mixcomp_get_meters(engine, &meters);
+    std::printf("%s: %d ch, %d samples @ %.0f Hz, kernels %s, latency %d, final GR %.2f dB\n",
+                outputPath.c_str(), numChannels, numSamples, audio.sampleRate,
+                mixcomp_get_kernel_variant(engine), mixcomp_get_latency(engine), meters.gain_reduction_db);
+
+    mixcomp_destroy(engine);
+
+    if (recordPath != nullptr && !gainWriter.close())
+    {
+        std::fprintf(stderr, "cannot write %s\n", recordPath);
+        return 1;
+    }
+
+    if (!audio.write(outputPath, error))
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    return 0;
+}
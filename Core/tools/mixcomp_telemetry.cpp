@@ -0,0 +1,96 @@
+// Lists every instance publishing telemetry on this machine (plugin and C API alike).
+//
+//   mixcomp_telemetry [--once] [--interval MS]
+//
+// Refreshes in place until interrupted; --once prints a single table. Instances that have
+// not published for a second are shown as idle (stopped, bypassed or not playing). Plugin
+// instances only publish when started with MIXCOMP_TELEMETRY=1.
+
+#include "../Telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    float toDecibels(float linear)
+    {
+        return linear > 1.0e-5f ? 20.0f * std::log10(linear) : -100.0f;
+    }
+
+    void printTable(const Telemetry::Entry* entries, int numEntries)
+    {
+        static const char* tierNames[] = { "full", "lut", "eco" };
+        const auto now = Telemetry::now();
+
+        std::printf("%-4s %-7s %-24s %6s %7s %7s %8s %8s %8s %6s %-4s %s\n",
+                    "slot", "pid", "label", "GR dB", "in dB", "out dB", "clips", "avg us", "max us", "load", "tier", "state");
+
+        for (int i = 0; i < numEntries; ++i)
+        {
+            const auto& entry = entries[i];
+            const auto& record = entry.record;
+            const double ageSeconds = now > record.timestampNanos ? static_cast<double>(now - record.timestampNanos) * 1.0e-9 : 0.0;
+            const int tier = record.qualityTier >= 0 && record.qualityTier <= 2 ? record.qualityTier : 0;
+
+            std::printf("%-4d %-7u %-24.24s %6.1f %7.1f %7.1f %8llu %8.1f %8.1f %5.1f%% %-4s %s\n",
+                        entry.slotIndex, entry.ownerProcess, entry.label,
+                        record.gainReductionDB, toDecibels(record.inputRMS), toDecibels(record.outputRMS),
+                        static_cast<unsigned long long>(record.clipCount),
+                        record.callbackMeanMicros, record.callbackMaxMicros, record.load * 100.0f,
+                        tierNames[tier], ageSeconds > 1.0 ? "idle" : "live");
+        }
+
+        if (numEntries == 0)
+            std::printf("(no instances)\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool once = false;
+    int intervalMs = 500;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--once") == 0)
+            once = true;
+        else if (std::strcmp(argv[i], "--interval") == 0 && i + 1 < argc)
+            intervalMs = std::max(50, std::atoi(argv[++i]));
+        else
+        {
+            std::fprintf(stderr, "usage: mixcomp_telemetry [--once] [--interval MS]\n");
+            return 2;
+        }
+    }
+
+    Telemetry::Mapping mapping;
+    if (!mapping.open(false))
+    {
+        std::fprintf(stderr, "no telemetry segment (no instance has published yet; plugins need MIXCOMP_TELEMETRY=1)\n");
+        return 1;
+    }
+
+    static Telemetry::Entry entries[Telemetry::maxSlots];
+
+    for (;;)
+    {
+        const int numEntries = Telemetry::readAll(*mapping.get(), entries, Telemetry::maxSlots);
+
+        if (!once)
+            std::printf("\x1b[H\x1b[2J");
+
+        printTable(entries, numEntries);
+        std::fflush(stdout);
+
+        if (once)
+            return 0;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+}
@@ -0,0 +1,89 @@
+#include "LevelHistory.h"
+
+//==============================================================================
+void HistoryBin::merge(const HistoryBin& other) noexcept
+{
+    grMin = juce::jmin(grMin, other.grMin);
+    grMax = juce::jmax(grMax, other.grMax);
+    inputMin = juce::jmin(inputMin, other.inputMin);
+    inputMax = juce::jmax(inputMax, other.inputMax);
+    outputMin = juce::jmin(outputMin, other.outputMin);
+    outputMax = juce::jmax(outputMax, other.outputMax);
+}
+
+//==============================================================================
+LevelHistory::LevelHistory()
+{
+    // Every level spans the same time: capacity halves as resolution halves
+    for (int level = 0; level < numLevels; ++level)
+        levels[level].resize((size_t)(level0Capacity >> level));
+}
+
+void LevelHistory::clear()
+{
+    totalBins = 0;
+}
+
+void LevelHistory::push(const HistoryBin& bin)
+{
+    auto index = totalBins++;
+    levels[0][(size_t)(index % level0Capacity)] = bin;
+
+    // Each time a group of 2^level raw bins completes, fold the two children below it
+    for (int level = 1; level < numLevels; ++level)
+    {
+        if ((totalBins & ((juce::int64(1) << level) - 1)) != 0)
+            break;
+
+        auto entry = (totalBins >> level) - 1;
+        auto merged = entryAt(level - 1, entry * 2);
+        merged.merge(entryAt(level - 1, entry * 2 + 1));
+
+        auto capacity = juce::int64(level0Capacity >> level);
+        levels[level][(size_t)(entry % capacity)] = merged;
+    }
+}
+
+juce::int64 LevelHistory::getNumAvailableBins() const noexcept
+{
+    return juce::jmin(totalBins, juce::int64(level0Capacity));
+}
+
+const HistoryBin& LevelHistory::entryAt(int level, juce::int64 index) const noexcept
+{
+    auto capacity = juce::int64(level0Capacity >> level);
+    return levels[level][(size_t)(index % capacity)];
+}
+
+bool LevelHistory::getRange(juce::int64 binsAgo, juce::int64 numBins, HistoryBin& result) const
+{
+    auto end = totalBins - binsAgo;
+    auto start = juce::jmax(end - numBins, totalBins - getNumAvailableBins());
+
+    if (start >= end)
+        return false;
+
+    // Cover [start, end) with the largest aligned blocks available, so the cost is
+    // logarithmic in the range and independent of how much history is stored
+    bool first = true;
+    while (start < end)
+    {
+        int level = 0;
+        while (level + 1 < numLevels
+               && (start & ((juce::int64(1) << (level + 1)) - 1)) == 0
+               && start + (juce::int64(1) << (level + 1)) <= end)
+            ++level;
+
+        const auto& entry = entryAt(level, start >> level);
+
+        if (first)
+            result = entry;
+        else
+            result.merge(entry);
+
+        first = false;
+        start += juce::int64(1) << level;
+    }
+
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// One history bin: gain reduction and input/output peak levels over a fixed
+// stretch of audio (all values in dB)
+struct HistoryBin
+{
+    float grMin = 0.0f, grMax = 0.0f;
+    float inputMin = -100.0f, inputMax = -100.0f;
+    float outputMin = -100.0f, outputMax = -100.0f;
+
+    void merge(const HistoryBin& other) noexcept;
+};
+
+//==============================================================================
+// Fixed-memory min/max mipmap (decimation pyramid) of history bins.
+// Level 0 holds the raw bins; each level above halves the resolution and every
+// level spans the same length of time, so a query for any pixel column touches
+// at most a couple of entries regardless of how much history is kept.
+// Not thread-safe: written and read on the message thread only.
+class LevelHistory
+{
+public:
+    LevelHistory();
+
+    void clear();
+    void push(const HistoryBin& bin);
+
+    // Number of level 0 bins that can still be queried
+    juce::int64 getNumAvailableBins() const noexcept;
+
+    // Aggregates numBins bins ending binsAgo bins before the newest one.
+    // Returns false if none of the requested range is still held.
+    bool getRange(juce::int64 binsAgo, juce::int64 numBins, HistoryBin& result) const;
+
+    static constexpr int numLevels = 10;
+    static constexpr int level0Capacity = 1 << 15; // ~5.5 minutes of 10ms bins
+
+private:
+    std::vector<HistoryBin> levels[numLevels];
+    juce::int64 totalBins = 0; // level 0 bins ever pushed
+
+    const HistoryBin& entryAt(int level, juce::int64 index) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelHistory)
+};
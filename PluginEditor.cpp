@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PresetBrowser.h"
 
 //==============================================================================
 void MixCompressorAudioProcessorEditor::setupRotarySlider(juce::Slider& slider)
@@ -65,6 +66,82 @@ void MixCompressorAudioProcessorEditor::GainReductionMeter::paint(juce::Graphics
 
     g.setColour(juce::Colours::white.withAlpha(0.5f));
     g.drawRoundedRectangle(meterBounds.toFloat(), 3.0f, 1.0f);
+
+    // Adaptive quality tier and load
+    if (adaptive)
+    {
+        static const char* tierNames[] = { "FULL", "LUT", "ECO" };
+        const auto tierName = tierNames[juce::jlimit(0, 2, qualityTier)];
+
+        g.setColour(qualityTier > 0 ? juce::Colour(0xffffa500) : juce::Colours::white.withAlpha(0.7f));
+        g.setFont(juce::FontOptions(10.0f, juce::Font::bold));
+        g.drawText(juce::String(tierName) + " " + juce::String(cpuLoad * 100.0f, 1) + "%",
+            meterBounds.reduced(4, 2).removeFromTop(12), juce::Justification::right);
+    }
+}
+
+//==============================================================================
+void MixCompressorAudioProcessorEditor::HistoryView::paint(juce::Graphics& g)
+{
+    auto viewBounds = getLocalBounds().reduced(5);
+    g.setColour(juce::Colours::black);
+    g.fillRoundedRectangle(viewBounds.toFloat(), 3.0f);
+
+    auto top = float(viewBounds.getY());
+    auto bottom = float(viewBounds.getBottom());
+
+    // Level grid (-60..0 dB)
+    g.setColour(juce::Colours::white.withAlpha(0.1f));
+    for (int db = 0; db >= -60; db -= 12)
+    {
+        float y = juce::jmap(float(db), -60.0f, 0.0f, bottom, top);
+        g.drawHorizontalLine(int(y), float(viewBounds.getX()), float(viewBounds.getRight()));
+    }
+
+    const auto& history = processor.getLevelHistory();
+    const double binsPerPixel = visibleSeconds / processor.getHistoryBinSeconds() / juce::jmax(1, viewBounds.getWidth());
+
+    auto levelToY = [top, bottom](float db) { return juce::jmap(juce::jlimit(-60.0f, 0.0f, db), -60.0f, 0.0f, bottom, top); };
+    auto grToY = [top, bottom](float db) { return juce::jmap(juce::jlimit(0.0f, 24.0f, db), 0.0f, 24.0f, top, bottom); };
+
+    // One range query per pixel column, newest at the right edge
+    for (int column = 0; column < viewBounds.getWidth(); ++column)
+    {
+        int x = viewBounds.getRight() - 1 - column;
+        auto binsAgo = juce::int64(column * binsPerPixel);
+        auto numBins = juce::jmax(juce::int64(1), juce::int64((column + 1) * binsPerPixel) - binsAgo);
+
+        HistoryBin bin;
+        if (!history.getRange(binsAgo, numBins, bin))
+            break;
+
+        g.setColour(juce::Colours::grey.withAlpha(0.5f));
+        g.drawVerticalLine(x, levelToY(bin.inputMax), juce::jmax(levelToY(bin.inputMin), levelToY(bin.inputMax) + 1.0f));
+
+        g.setColour(juce::Colour(0xff4a9eff).withAlpha(0.8f));
+        g.drawVerticalLine(x, levelToY(bin.outputMax), juce::jmax(levelToY(bin.outputMin), levelToY(bin.outputMax) + 1.0f));
+
+        if (bin.grMax > 0.1f)
+        {
+            g.setColour(juce::Colours::red.withAlpha(0.8f));
+            g.drawVerticalLine(x, grToY(bin.grMin), juce::jmax(grToY(bin.grMax), grToY(bin.grMin) + 1.0f));
+        }
+    }
+
+    g.setColour(juce::Colours::white.withAlpha(0.6f));
+    g.setFont(juce::FontOptions(10.0f));
+    g.drawText("HISTORY " + juce::String(visibleSeconds, 1) + " s  (scroll to zoom)",
+        viewBounds.reduced(6, 4), juce::Justification::topLeft);
+
+    g.setColour(juce::Colours::white.withAlpha(0.5f));
+    g.drawRoundedRectangle(viewBounds.toFloat(), 3.0f, 1.0f);
+}
+
+void MixCompressorAudioProcessorEditor::HistoryView::mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel)
+{
+    const double maxSeconds = LevelHistory::level0Capacity * processor.getHistoryBinSeconds();
+    visibleSeconds = juce::jlimit(2.0, maxSeconds, visibleSeconds * (wheel.deltaY > 0 ? 0.8 : 1.25));
+    repaint();
 }
 
 //==============================================================================
@@ -93,6 +170,15 @@ MixCompressorAudioProcessorEditor::MixCompressorAudioProcessorEditor(MixCompress
     presetAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.getValueTreeState(), "preset", presetSelector);
 
+    // Preset library browser
+    libraryButton.setButtonText("Library");
+    libraryButton.onClick = [this]
+        {
+            juce::CallOutBox::launchAsynchronously(std::make_unique<PresetBrowser>(audioProcessor),
+                libraryButton.getBounds(), this);
+        };
+    addAndMakeVisible(libraryButton);
+
     // Topology Selector (NEW PLUS feature)
     topologySelector.addItem("VCA (Clean/Odd)", 1);
     topologySelector.addItem("FET (Aggressive/2nd+3rd)", 2);
@@ -108,6 +194,46 @@ MixCompressorAudioProcessorEditor::MixCompressorAudioProcessorEditor(MixCompress
     scHPFAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.getValueTreeState(), "scHPF", scHPFSlider);
 
+    // Side-chain detector EQ
+    scEQSelector.addItem("Flat", 1);
+    scEQSelector.addItem("Tilt", 2);
+    scEQSelector.addItem("Bell", 3);
+    addAndMakeVisible(scEQSelector);
+    scEQAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "scEQ", scEQSelector);
+    setupLabel(scEQLabel, "SC EQ");
+
+    setupRotarySlider(scEQFreqSlider);
+    setupRotarySlider(scEQGainSlider);
+    setupLabel(scEQFreqLabel, "SC FREQ");
+    setupLabel(scEQGainLabel, "SC GAIN");
+    scEQFreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "scEQFreq", scEQFreqSlider);
+    scEQGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "scEQGain", scEQGainSlider);
+
+    // Detector rate
+    detectorRateSelector.addItem("Auto", 1);
+    detectorRateSelector.addItem("Audio Rate", 2);
+    addAndMakeVisible(detectorRateSelector);
+    detectorRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "detectorRate", detectorRateSelector);
+    setupLabel(detectorRateLabel, "DETECTOR");
+
+    // Detector link group (name is plugin state, not a parameter)
+    linkModeSelector.addItem("Link Off", 1);
+    linkModeSelector.addItem("Link Max", 2);
+    linkModeSelector.addItem("Link Sum", 3);
+    addAndMakeVisible(linkModeSelector);
+    linkModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "linkMode", linkModeSelector);
+
+    linkGroupEditor.setTextToShowWhenEmpty("link group", juce::Colours::grey);
+    linkGroupEditor.setText(audioProcessor.getLinkGroup(), juce::dontSendNotification);
+    linkGroupEditor.onReturnKey = [this] { audioProcessor.setLinkGroup(linkGroupEditor.getText()); };
+    linkGroupEditor.onFocusLost = [this] { audioProcessor.setLinkGroup(linkGroupEditor.getText()); };
+    addAndMakeVisible(linkGroupEditor);
+
     // Stage 1 controls
     setupRotarySlider(threshold1Slider);
     setupRotarySlider(ratio1Slider);
@@ -179,13 +305,62 @@ MixCompressorAudioProcessorEditor::MixCompressorAudioProcessorEditor(MixCompress
     autoMakeupAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.getValueTreeState(), "autoMakeup", autoMakeupToggle);
 
+    adaptiveQualityToggle.setButtonText("Adaptive CPU");
+    adaptiveQualityToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    adaptiveQualityToggle.setColour(juce::ToggleButton::tickColourId, accentColour);
+    addAndMakeVisible(adaptiveQualityToggle);
+    adaptiveQualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getValueTreeState(), "adaptiveQuality", adaptiveQualityToggle);
+
+    // Below-threshold segments
+    setupRotarySlider(upwardThresholdSlider);
+    setupRotarySlider(upwardRatioSlider);
+    setupRotarySlider(expanderThresholdSlider);
+    setupRotarySlider(expanderRatioSlider);
+    setupRotarySlider(expanderRangeSlider);
+
+    setupLabel(upwardThresholdLabel, "UPWARD THR");
+    setupLabel(upwardRatioLabel, "UPWARD RATIO");
+    setupLabel(expanderThresholdLabel, "EXPANDER THR");
+    setupLabel(expanderRatioLabel, "EXPANDER RATIO");
+    setupLabel(expanderRangeLabel, "RANGE");
+
+    upwardThresholdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "upwardThreshold", upwardThresholdSlider);
+    upwardRatioAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "upwardRatio", upwardRatioSlider);
+    expanderThresholdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "expanderThreshold", expanderThresholdSlider);
+    expanderRatioAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "expanderRatio", expanderRatioSlider);
+    expanderRangeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "expanderRange", expanderRangeSlider);
+
+    // Output limiter
+    limiterToggle.setButtonText("Limiter");
+    limiterToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    limiterToggle.setColour(juce::ToggleButton::tickColourId, accentColour);
+    addAndMakeVisible(limiterToggle);
+    limiterAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getValueTreeState(), "outputLimiter", limiterToggle);
+
+    setupRotarySlider(limiterCeilingSlider);
+    setupRotarySlider(limiterReleaseSlider);
+    setupLabel(limiterCeilingLabel, "CEILING");
+    setupLabel(limiterReleaseLabel, "LIM RELEASE");
+    limiterCeilingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "limiterCeiling", limiterCeilingSlider);
+    limiterReleaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "limiterRelease", limiterReleaseSlider);
+
     // Gain reduction meter
     addAndMakeVisible(grMeter);
+    addAndMakeVisible(historyView);
 
     // Start timer for metering
     startTimerHz(30);
 
-    setSize(800, 550);
+    setSize(800, 910);
 }
 
 MixCompressorAudioProcessorEditor::~MixCompressorAudioProcessorEditor()
@@ -213,12 +388,17 @@ void MixCompressorAudioProcessorEditor::paint(juce::Graphics& g)
     g.fillRoundedRectangle(15, 70, 770, 180, 5);  // Stage 1
     g.fillRoundedRectangle(15, 260, 770, 180, 5); // Stage 2
     g.fillRoundedRectangle(15, 450, 770, 85, 5);  // Global/New Controls
+    g.fillRoundedRectangle(15, 545, 770, 95, 5);  // Below threshold
+    g.fillRoundedRectangle(15, 650, 770, 85, 5);  // Output limiter
+    g.fillRoundedRectangle(15, 745, 770, 155, 5); // History
 
     // Section labels
     g.setColour(accentColour);
     g.setFont(juce::FontOptions(14.0f, juce::Font::bold));
     g.drawText("STAGE 1 - LEVELER", 25, 75, 200, 20, juce::Justification::left);
     g.drawText("STAGE 2 - PEAK CATCHER", 25, 265, 200, 20, juce::Justification::left);
+    g.drawText("BELOW THRESHOLD", 560, 555, 200, 20, juce::Justification::left);
+    g.drawText("OUTPUT LIMITER", 560, 660, 200, 20, juce::Justification::left);
 
     // Info text
     g.setColour(juce::Colours::lightgrey);
@@ -227,12 +407,21 @@ void MixCompressorAudioProcessorEditor::paint(juce::Graphics& g)
         25, 240, 450, 15, juce::Justification::left);
     g.drawText("Topology emulation: VCA (0.01-0.1% THD) | FET (0.1-0.5% THD) | Optical (0.05-0.3% THD)",
         25, 432, 600, 15, juce::Justification::left);
+    g.drawFittedText("Stage 1 detector: upward compression, then expansion / gate (ratio 1 = off)",
+        560, 575, 215, 45, juce::Justification::topLeft, 3);
+    g.drawFittedText("Look-ahead brickwall in place of the soft clip (adds 1.5 ms latency)",
+        560, 680, 215, 45, juce::Justification::topLeft, 3);
 }
 
 void MixCompressorAudioProcessorEditor::resized()
 {
     // Preset selector
-    presetSelector.setBounds(600, 15, 185, 30);
+    presetSelector.setBounds(600, 15, 120, 30);
+    libraryButton.setBounds(725, 15, 60, 30);
+
+    // Detector link
+    linkModeSelector.setBounds(420, 15, 85, 30);
+    linkGroupEditor.setBounds(510, 15, 80, 30);
 
     // Stage 1 controls
     int stage1Y = 100;
@@ -250,10 +439,20 @@ void MixCompressorAudioProcessorEditor::resized()
     topologyLabel.setBounds(550, stage1Y + 30, 220, 15);
     scHPFSlider.setBounds(575, stage1Y + 50, 80, 80);
     scHPFLabel.setBounds(575, stage1Y + 135, 80, 15);
+    detectorRateSelector.setBounds(665, stage1Y + 70, 110, 22);
+    detectorRateLabel.setBounds(665, stage1Y + 95, 110, 15);
 
     // Stage 2 toggle
     dualStageToggle.setBounds(25, 290, 100, 20);
 
+    // Side-chain detector EQ
+    scEQSelector.setBounds(550, 290, 220, 25);
+    scEQLabel.setBounds(550, 318, 220, 15);
+    scEQFreqSlider.setBounds(560, 335, 80, 80);
+    scEQFreqLabel.setBounds(560, 415, 80, 15);
+    scEQGainSlider.setBounds(670, 335, 80, 80);
+    scEQGainLabel.setBounds(670, 415, 80, 15);
+
     // Stage 2 controls
     int stage2Y = 320;
     threshold2Slider.setBounds(30, stage2Y, 100, 100);
@@ -273,13 +472,42 @@ void MixCompressorAudioProcessorEditor::resized()
     mixLabel.setBounds(130, globalY + 65, 80, 15);
     kneeSlider.setBounds(230, globalY, 80, 80);
     kneeLabel.setBounds(230, globalY + 65, 80, 15);
-    autoMakeupToggle.setBounds(330, globalY + 30, 120, 20);
+    autoMakeupToggle.setBounds(330, globalY + 15, 120, 20);
+    adaptiveQualityToggle.setBounds(330, globalY + 40, 120, 20);
 
     // Gain Reduction Meter
     grMeter.setBounds(480, globalY + 10, 295, 50);
+
+    // Below-threshold segments
+    int belowY = 550;
+    upwardThresholdSlider.setBounds(30, belowY, 80, 80);
+    upwardThresholdLabel.setBounds(30, belowY + 65, 80, 15);
+    upwardRatioSlider.setBounds(130, belowY, 80, 80);
+    upwardRatioLabel.setBounds(130, belowY + 65, 80, 15);
+    expanderThresholdSlider.setBounds(230, belowY, 80, 80);
+    expanderThresholdLabel.setBounds(230, belowY + 65, 80, 15);
+    expanderRatioSlider.setBounds(330, belowY, 80, 80);
+    expanderRatioLabel.setBounds(330, belowY + 65, 80, 15);
+    expanderRangeSlider.setBounds(430, belowY, 80, 80);
+    expanderRangeLabel.setBounds(430, belowY + 65, 80, 15);
+
+    // Output limiter
+    int limiterY = 655;
+    limiterToggle.setBounds(25, limiterY + 25, 100, 20);
+    limiterCeilingSlider.setBounds(130, limiterY, 80, 80);
+    limiterCeilingLabel.setBounds(130, limiterY + 65, 80, 15);
+    limiterReleaseSlider.setBounds(230, limiterY, 80, 80);
+    limiterReleaseLabel.setBounds(230, limiterY + 65, 80, 15);
+
+    // Scrolling history
+    historyView.setBounds(20, 750, 760, 145);
 }
 
 void MixCompressorAudioProcessorEditor::timerCallback()
 {
+    grMeter.setQuality(audioProcessor.isAdaptiveQualityEnabled(), audioProcessor.getQualityTier(), audioProcessor.getCPULoad());
     grMeter.setGainReduction(audioProcessor.getCurrentGainReduction());
+
+    audioProcessor.updateHistory();
+    historyView.repaint();
 }
\ No newline at end of file
@@ -23,9 +23,28 @@ private:
     public:
         void paint(juce::Graphics& g) override;
         void setGainReduction(float gr) { gainReduction = gr; repaint(); }
+        void setQuality(bool isAdaptive, int tier, float load) { adaptive = isAdaptive; qualityTier = tier; cpuLoad = load; }
 
     private:
         float gainReduction = 0.0f;
+        bool adaptive = false;
+        int qualityTier = 0;
+        float cpuLoad = 0.0f;
+    };
+
+    //==============================================================================
+    // Scrolling GR / level history; drawing cost scales with width, not history length
+    class HistoryView : public juce::Component
+    {
+    public:
+        explicit HistoryView(MixCompressorAudioProcessor& p) : processor(p) {}
+
+        void paint(juce::Graphics& g) override;
+        void mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel) override;
+
+    private:
+        MixCompressorAudioProcessor& processor;
+        double visibleSeconds = 30.0;
     };
 
     //==============================================================================
@@ -35,6 +54,9 @@ private:
     juce::ComboBox presetSelector;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> presetAttachment;
 
+    // Opens the preset library browser in a call-out
+    juce::TextButton libraryButton;
+
     // NEW: Topology & SC HPF Controls
     juce::ComboBox topologySelector;
     juce::Slider scHPFSlider;
@@ -42,6 +64,24 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> topologyAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> scHPFAttachment;
 
+    // Side-chain detector EQ
+    juce::ComboBox scEQSelector;
+    juce::Slider scEQFreqSlider, scEQGainSlider;
+    juce::Label scEQLabel, scEQFreqLabel, scEQGainLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> scEQAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> scEQFreqAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> scEQGainAttachment;
+
+    // Detector rate (Auto decimates slow detectors)
+    juce::ComboBox detectorRateSelector;
+    juce::Label detectorRateLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> detectorRateAttachment;
+
+    // Detector link group
+    juce::ComboBox linkModeSelector;
+    juce::TextEditor linkGroupEditor;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> linkModeAttachment;
+
     // Stage 1 controls
     juce::Slider threshold1Slider, ratio1Slider, attack1Slider, release1Slider;
     juce::Label threshold1Label, ratio1Label, attack1Label, release1Label;
@@ -63,14 +103,33 @@ private:
     // Global controls
     juce::Slider makeupSlider, mixSlider, kneeSlider;
     juce::Label makeupLabel, mixLabel, kneeLabel;
-    juce::ToggleButton autoMakeupToggle;
+    juce::ToggleButton autoMakeupToggle, adaptiveQualityToggle;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> makeupAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> mixAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> kneeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> autoMakeupAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> adaptiveQualityAttachment;
+
+    // Below-threshold segments (upward compression, expander / gate)
+    juce::Slider upwardThresholdSlider, upwardRatioSlider, expanderThresholdSlider, expanderRatioSlider, expanderRangeSlider;
+    juce::Label upwardThresholdLabel, upwardRatioLabel, expanderThresholdLabel, expanderRatioLabel, expanderRangeLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> upwardThresholdAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> upwardRatioAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> expanderThresholdAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> expanderRatioAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> expanderRangeAttachment;
+
+    // Output limiter
+    juce::ToggleButton limiterToggle;
+    juce::Slider limiterCeilingSlider, limiterReleaseSlider;
+    juce::Label limiterCeilingLabel, limiterReleaseLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> limiterAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> limiterCeilingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> limiterReleaseAttachment;
 
     // Metering
     GainReductionMeter grMeter;
+    HistoryView historyView{ audioProcessor };
 
     // Styling
     juce::Colour backgroundColour;
@@ -26,6 +26,24 @@ juce::AudioProcessorValueTreeState::ParameterLayout MixCompressorAudioProcessor:
         80.0f,
         juce::AudioParameterFloatAttributes().withLabel("Hz")));
 
+    // Side-chain detector EQ shape (tilt for program-dependent, bell for de-essing / kick focus)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("scEQ", 1), "SC EQ",
+        juce::StringArray{ "Flat", "Tilt", "Bell" },
+        0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("scEQFreq", 1), "SC EQ Freq",
+        juce::NormalisableRange<float>(50.0f, 12000.0f, 1.0f, 0.3f),
+        1000.0f,
+        juce::AudioParameterFloatAttributes().withLabel("Hz")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("scEQGain", 1), "SC EQ Gain",
+        juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("dB")));
+
     // Stage 1 (Leveler) - optimized for envelope following
     layout.add(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID("threshold1", 1), "Threshold 1",
@@ -88,10 +106,91 @@ juce::AudioProcessorValueTreeState::ParameterLayout MixCompressorAudioProcessor:
         juce::NormalisableRange<float>(0.0f, 24.0f, 0.1f), 6.0f,
         juce::AudioParameterFloatAttributes().withLabel("dB")));
 
+    // Below threshold 1, from the same detector: upward compression, then expansion / gate.
+    // A ratio of 1 turns either off.
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("upwardThreshold", 1), "Upward Threshold",
+        juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -40.0f,
+        juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("upwardRatio", 1), "Upward Ratio",
+        juce::NormalisableRange<float>(1.0f, 4.0f, 0.1f), 1.0f,
+        juce::AudioParameterFloatAttributes().withLabel(":1")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("expanderThreshold", 1), "Expander Threshold",
+        juce::NormalisableRange<float>(-80.0f, 0.0f, 0.1f), -60.0f,
+        juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("expanderRatio", 1), "Expander Ratio",
+        juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f, 0.5f), 1.0f,
+        juce::AudioParameterFloatAttributes().withLabel(":1")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("expanderRange", 1), "Expander Range",
+        juce::NormalisableRange<float>(0.0f, 40.0f, 0.1f), 40.0f,
+        juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+    // Output limiter: look-ahead brickwall in place of the soft clip (adds its look-ahead as latency)
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("outputLimiter", 1), "Output Limiter", false));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("limiterCeiling", 1), "Limiter Ceiling",
+        juce::NormalisableRange<float>(-24.0f, 0.0f, 0.1f), -0.3f,
+        juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("limiterRelease", 1), "Limiter Release",
+        juce::NormalisableRange<float>(1.0f, 1000.0f, 1.0f, 0.5f), 50.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")));
+
     // Auto makeup toggle
     layout.add(std::make_unique<juce::AudioParameterBool>(
         juce::ParameterID("autoMakeup", 1), "Auto Makeup", true));
 
+    // Detector rate: Auto decimates the detector when the time constants allow it
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("detectorRate", 1), "Detector Rate",
+        juce::StringArray{ "Auto", "Audio Rate" },
+        0));
+
+    // Detector link: key on the loudest (Max) or summed (Sum) level of the instances in the link group
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("linkMode", 1), "Link Mode",
+        juce::StringArray{ "Off", "Max", "Sum" },
+        0));
+
+    // Adaptive quality: cheaper gain curve / detector tiers while over the CPU budget
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("adaptiveQuality", 1), "Adaptive Quality", false));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("cpuBudget", 1), "CPU Budget",
+        juce::NormalisableRange<float>(1.0f, 100.0f, 1.0f), 10.0f,
+        juce::AudioParameterFloatAttributes().withLabel("%")));
+
+    // Detector quality for the realtime profile
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("truePeak", 1), "True Peak Detect", false));
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("doublePrecision", 1), "Double Precision", false));
+
+    // Offline profile, used instead of the realtime quality settings while the host bounces.
+    // Always the exact gain curve (no adaptive quality); none of it changes the latency.
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("offlineProfile", 1), "Offline Profile", true));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("offlineDetectorRate", 1), "Offline Detector Rate",
+        juce::StringArray{ "Auto", "Audio Rate" },
+        1));
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("offlineTruePeak", 1), "Offline True Peak Detect", true));
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("offlineDoublePrecision", 1), "Offline Double Precision", true));
+
     return layout;
 }
 
@@ -109,11 +208,57 @@ MixCompressorAudioProcessor::MixCompressorAudioProcessor()
 #endif
     apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
-    makeupGainSmoothed.reset(44100.0, 0.05); // 50ms smoothing
+    // Coefficient and table rebuilds happen on the resource worker, not in processBlock
+    engine.setBackgroundPreparation(true);
+
+    // Session-wide monitoring (tools/mixcomp_telemetry), opt-in with MIXCOMP_TELEMETRY=1;
+    // labelled with the track name once the host reports it
+    if (Telemetry::isEnabledByEnvironment())
+        engine.enableTelemetry(JucePlugin_Name);
+
+    scHPFParam = apvts.getRawParameterValue("scHPF");
+    topologyParam = apvts.getRawParameterValue("topology");
+    threshold1Param = apvts.getRawParameterValue("threshold1");
+    ratio1Param = apvts.getRawParameterValue("ratio1");
+    attack1Param = apvts.getRawParameterValue("attack1");
+    release1Param = apvts.getRawParameterValue("release1");
+    kneeParam = apvts.getRawParameterValue("knee");
+    dualStageParam = apvts.getRawParameterValue("dualStage");
+    threshold2Param = apvts.getRawParameterValue("threshold2");
+    ratio2Param = apvts.getRawParameterValue("ratio2");
+    attack2Param = apvts.getRawParameterValue("attack2");
+    release2Param = apvts.getRawParameterValue("release2");
+    makeupParam = apvts.getRawParameterValue("makeup");
+    autoMakeupParam = apvts.getRawParameterValue("autoMakeup");
+    mixParam = apvts.getRawParameterValue("mix");
+    detectorRateParam = apvts.getRawParameterValue("detectorRate");
+    scEQParam = apvts.getRawParameterValue("scEQ");
+    scEQFreqParam = apvts.getRawParameterValue("scEQFreq");
+    scEQGainParam = apvts.getRawParameterValue("scEQGain");
+    linkModeParam = apvts.getRawParameterValue("linkMode");
+    adaptiveQualityParam = apvts.getRawParameterValue("adaptiveQuality");
+    cpuBudgetParam = apvts.getRawParameterValue("cpuBudget");
+    upwardThresholdParam = apvts.getRawParameterValue("upwardThreshold");
+    upwardRatioParam = apvts.getRawParameterValue("upwardRatio");
+    expanderThresholdParam = apvts.getRawParameterValue("expanderThreshold");
+    expanderRatioParam = apvts.getRawParameterValue("expanderRatio");
+    expanderRangeParam = apvts.getRawParameterValue("expanderRange");
+    outputLimiterParam = apvts.getRawParameterValue("outputLimiter");
+    limiterCeilingParam = apvts.getRawParameterValue("limiterCeiling");
+    limiterReleaseParam = apvts.getRawParameterValue("limiterRelease");
+    truePeakParam = apvts.getRawParameterValue("truePeak");
+    doublePrecisionParam = apvts.getRawParameterValue("doublePrecision");
+    offlineProfileParam = apvts.getRawParameterValue("offlineProfile");
+    offlineDetectorRateParam = apvts.getRawParameterValue("offlineDetectorRate");
+    offlineTruePeakParam = apvts.getRawParameterValue("offlineTruePeak");
+    offlineDoublePrecisionParam = apvts.getRawParameterValue("offlineDoublePrecision");
+
+    startTimer(housekeepingIntervalMs);
 }
 
 MixCompressorAudioProcessor::~MixCompressorAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -183,42 +328,22 @@ void MixCompressorAudioProcessor::changeProgramName(int index, const juce::Strin
 //==============================================================================
 void MixCompressorAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    // Initialize DSP
-    stage1.prepare(sampleRate);
-    stage2.prepare(sampleRate);
-    makeupGainSmoothed.reset(sampleRate, 0.05);
-    makeupGainSmoothed.setCurrentAndTargetValue(1.0f);
-
-    // Initialize side-chain HPF
-    juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32)samplesPerBlock, 2 };
-    for (int i = 0; i < 2; ++i)
-    {
-        sideChainHPF[i].prepare(spec);
-        sideChainHPF[i].setType(juce::dsp::StateVariableTPTFilterType::highpass);
-        sideChainHPF[i].setCutoffFrequency(80.0f);
-    }
-
-    // Look-ahead for phase coherence (1ms typical)
-    lookAheadSamples = juce::roundToInt(sampleRate * 0.001);
-    lookAheadSamples = juce::jmin(lookAheadSamples, maxLookAheadSamples);
-
-    lookAheadBuffer.prepare(spec);
-    lookAheadBuffer.reset(); // FIXED: was .clear() in JUCE 7
-
-    // Reset state
-    inputRMS = 0.0f;
-    outputRMS = 0.0f;
-    for (int i = 0; i < 2; ++i)
-    {
-        dcBlockerX1[i] = 0.0f;
-        dcBlockerY1[i] = 0.0f;
-    }
+    juce::ignoreUnused(samplesPerBlock);
+
+    // The engine picks its kernel variant and clears all state; its sub-block grid makes the
+    // output independent of the host buffer size, so the block size is not needed
+    resourceWorker.stop();
+    engine.setParameters(getEngineParameters());
+    engine.prepare(sampleRate, 2);
+    resourceWorker.start(sampleRate);
+    engineLatency.store(engine.getLatencySamples(), std::memory_order_relaxed);
+    setLatencySamples(engine.getLatencySamples());
 }
 
 void MixCompressorAudioProcessor::releaseResources()
 {
-    stage1.reset();
-    stage2.reset();
+    resourceWorker.stop();
+    engine.reset();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -251,165 +376,134 @@ void MixCompressorAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Get parameters safely
-    auto* scHPFParam = apvts.getRawParameterValue("scHPF");
-    auto* topologyParam = apvts.getRawParameterValue("topology");
-    auto* threshold1Param = apvts.getRawParameterValue("threshold1");
-    auto* ratio1Param = apvts.getRawParameterValue("ratio1");
-    auto* attack1Param = apvts.getRawParameterValue("attack1");
-    auto* release1Param = apvts.getRawParameterValue("release1");
-    auto* kneeParam = apvts.getRawParameterValue("knee");
-    auto* dualStageParam = apvts.getRawParameterValue("dualStage");
-    auto* threshold2Param = apvts.getRawParameterValue("threshold2");
-    auto* ratio2Param = apvts.getRawParameterValue("ratio2");
-    auto* attack2Param = apvts.getRawParameterValue("attack2");
-    auto* release2Param = apvts.getRawParameterValue("release2");
-    auto* makeupParam = apvts.getRawParameterValue("makeup");
-    auto* autoMakeupParam = apvts.getRawParameterValue("autoMakeup");
-    auto* mixParam = apvts.getRawParameterValue("mix");
-
-    if (!scHPFParam || !topologyParam || !threshold1Param || !ratio1Param || !attack1Param ||
-        !release1Param || !kneeParam || !dualStageParam || !threshold2Param || !ratio2Param ||
-        !attack2Param || !release2Param || !makeupParam || !autoMakeupParam || !mixParam)
-        return;
-
-    auto scHPF = scHPFParam->load();
-    auto topology = static_cast<TopologyMode>(static_cast<int>(topologyParam->load()));
-    auto threshold1 = threshold1Param->load();
-    auto ratio1 = ratio1Param->load();
-    auto attack1 = attack1Param->load();
-    auto release1 = release1Param->load();
-    auto knee = kneeParam->load();
-    auto dualStage = dualStageParam->load() > 0.5f;
-    auto threshold2 = threshold2Param->load();
-    auto ratio2 = ratio2Param->load();
-    auto attack2 = attack2Param->load();
-    auto release2 = release2Param->load();
-    auto makeupDB = makeupParam->load();
-    auto autoMakeup = autoMakeupParam->load() > 0.5f;
-    auto mixPercent = mixParam->load();
-
-    // Update side-chain HPF cutoff
-    for (int i = 0; i < 2; ++i)
-        sideChainHPF[i].setCutoffFrequency(scHPF);
-
-    // Set compressor parameters
-    stage1.setParameters(threshold1, ratio1, attack1, release1, knee);
-    stage2.setParameters(threshold2, ratio2, attack2, release2, knee);
-
-    // Create dry buffer for parallel processing
-    juce::AudioBuffer<float> dryBuffer;
-    dryBuffer.makeCopyOf(buffer);
-
-    // Sidechain buffer for filtered detection
-    juce::AudioBuffer<float> scBuffer;
-    scBuffer.makeCopyOf(buffer);
-
-    // Apply HPF to sidechain
-    juce::dsp::AudioBlock<float> scBlock(scBuffer);
-    juce::dsp::ProcessContextReplacing<float> scContext(scBlock);
-    for (int ch = 0; ch < totalNumInputChannels; ++ch)
+    // The engine snapshots these at its next 32-sample boundary; a preset being applied is
+    // picked up whole on a later block
+    mixcomp_params params;
+    if (readEngineParameters(params))
     {
-        auto channelBlock = scBlock.getSingleChannelBlock(ch);
-        juce::dsp::ProcessContextReplacing<float> channelContext(channelBlock);
-        sideChainHPF[ch].process(channelContext);
+        engine.setParameters(params);
+        resourceWorker.checkParameters(params);
     }
 
-    float maxGR = 0.0f;
-    float sumInputSq = 0.0f;
-    float sumOutputSq = 0.0f;
-
-    // Process audio sample-by-sample with sidechain
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        auto* channelData = buffer.getWritePointer(channel);
-        auto* scData = scBuffer.getReadPointer(channel);
-
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
-        {
-            float input = channelData[i];
+    engine.process(buffer.getArrayOfWritePointers(), juce::jmin(totalNumInputChannels, 2), buffer.getNumSamples());
 
-            // DC blocker
-            float dcBlocked = applyDCBlocker(input, channel);
-            sumInputSq += dcBlocked * dcBlocked;
-
-            // Stage 1: Leveler (with sidechain)
-            float gr1 = 0.0f;
-            float output = stage1.processSample(dcBlocked, gr1, scData[i], topology);
-
-            // Stage 2: Peak Catcher (if enabled)
-            float gr2 = 0.0f;
-            if (dualStage)
-                output = stage2.processSample(output, gr2, scData[i], topology);
-
-            float totalGR = gr1 + gr2;
-            maxGR = juce::jmax(maxGR, totalGR);
-
-            channelData[i] = output;
-            sumOutputSq += output * output;
-        }
-    }
+    // Switching the output limiter changes the latency; the timer reports it to the host
+    // from the message thread (host notifications may lock or allocate)
+    engineLatency.store(engine.getLatencySamples(), std::memory_order_relaxed);
+}
 
-    // Update RMS for level-matched comparison
-    int numSamples = buffer.getNumSamples() * totalNumInputChannels;
-    if (numSamples > 0)
-    {
-        float instantInputRMS = std::sqrt(sumInputSq / numSamples);
-        float instantOutputRMS = std::sqrt(sumOutputSq / numSamples);
+void MixCompressorAudioProcessor::updateTrackProperties(const TrackProperties& properties)
+{
+    if (properties.name.has_value() && properties.name->isNotEmpty())
+        engine.setTelemetryLabel(properties.name->toRawUTF8());
+}
 
-        inputRMS = rmsAlpha * inputRMS + (1.0f - rmsAlpha) * instantInputRMS;
-        outputRMS = rmsAlpha * outputRMS + (1.0f - rmsAlpha) * instantOutputRMS;
-    }
+bool MixCompressorAudioProcessor::readEngineParameters(mixcomp_params& params) const
+{
+    const auto batch = parameterBatch.load(std::memory_order_acquire);
+    if ((batch & 1u) != 0)
+        return false;
 
-    // Calculate and smooth makeup gain (with 3dB headroom)
-    float targetMakeupGain = juce::Decibels::decibelsToGain(makeupDB);
+    params = getEngineParameters();
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return parameterBatch.load(std::memory_order_relaxed) == batch;
+}
 
-    if (autoMakeup && maxGR > 0.01f)
+mixcomp_params MixCompressorAudioProcessor::getEngineParameters() const
+{
+    mixcomp_params p;
+    p.topology = static_cast<int>(topologyParam->load());
+    p.sc_hpf_hz = scHPFParam->load();
+    p.sc_eq_shape = static_cast<int>(scEQParam->load());
+    p.sc_eq_freq_hz = scEQFreqParam->load();
+    p.sc_eq_gain_db = scEQGainParam->load();
+
+    p.threshold1_db = threshold1Param->load();
+    p.ratio1 = ratio1Param->load();
+    p.attack1_ms = attack1Param->load();
+    p.release1_ms = release1Param->load();
+
+    p.dual_stage = dualStageParam->load() > 0.5f ? 1 : 0;
+    p.threshold2_db = threshold2Param->load();
+    p.ratio2 = ratio2Param->load();
+    p.attack2_ms = attack2Param->load();
+    p.release2_ms = release2Param->load();
+
+    p.knee_db = kneeParam->load();
+    p.upward_threshold_db = upwardThresholdParam->load();
+    p.upward_ratio = upwardRatioParam->load();
+    p.expander_threshold_db = expanderThresholdParam->load();
+    p.expander_ratio = expanderRatioParam->load();
+    p.expander_range_db = expanderRangeParam->load();
+
+    p.output_limiter = outputLimiterParam->load() > 0.5f ? 1 : 0;
+    p.limiter_ceiling_db = limiterCeilingParam->load();
+    p.limiter_release_ms = limiterReleaseParam->load();
+
+    p.makeup_db = makeupParam->load();
+    p.auto_makeup = autoMakeupParam->load() > 0.5f ? 1 : 0;
+    p.mix_percent = mixParam->load();
+    p.detector_rate = static_cast<int>(detectorRateParam->load());
+    p.link_mode = static_cast<int>(linkModeParam->load());
+    p.adaptive_quality = adaptiveQualityParam->load() > 0.5f ? 1 : 0;
+    p.cpu_budget_percent = cpuBudgetParam->load();
+    p.true_peak_detect = truePeakParam->load() > 0.5f ? 1 : 0;
+    p.double_precision = doublePrecisionParam->load() > 0.5f ? 1 : 0;
+
+    if (isUsingOfflineProfile())
     {
-        float autoMakeupDB = calculateAutoMakeup(maxGR);
-        targetMakeupGain = juce::Decibels::decibelsToGain(autoMakeupDB);
+        p.detector_rate = static_cast<int>(offlineDetectorRateParam->load());
+        p.adaptive_quality = 0;
+        p.true_peak_detect = offlineTruePeakParam->load() > 0.5f ? 1 : 0;
+        p.double_precision = offlineDoublePrecisionParam->load() > 0.5f ? 1 : 0;
     }
 
-    makeupGainSmoothed.setTargetValue(targetMakeupGain);
-
-    // Apply mix (parallel compression)
-    float wetMix = mixPercent / 100.0f;
-    float dryMix = 1.0f - wetMix;
-
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        auto* wetData = buffer.getWritePointer(channel);
-        auto* dryData = dryBuffer.getReadPointer(channel);
-
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
-        {
-            float makeupGain = makeupGainSmoothed.getNextValue();
-            float wet = wetData[i] * makeupGain;
-            float dry = dryData[i];
-            wetData[i] = wet * wetMix + dry * dryMix;
+    return p;
+}
 
-            // Soft clip to prevent overshoots
-            wetData[i] = std::tanh(wetData[i] * 0.9f) / 0.9f;
-        }
-    }
+//==============================================================================
+void MixCompressorAudioProcessor::setLinkGroup(const juce::String& name)
+{
+    const auto trimmed = name.trim().substring(0, DetectorLink::maxNameLength);
+    apvts.state.setProperty(linkGroupProperty, trimmed, nullptr);
+    engine.setLinkGroup(trimmed.toRawUTF8());
+}
 
-    // Update gain reduction meter
-    currentGainReduction.store(maxGR);
+juce::String MixCompressorAudioProcessor::getLinkGroup() const
+{
+    return apvts.state.getProperty(linkGroupProperty).toString();
 }
 
 //==============================================================================
-float MixCompressorAudioProcessor::calculateAutoMakeup(float avgGainReduction)
+void MixCompressorAudioProcessor::timerCallback()
 {
-    // Compensate with 3dB headroom margin (psychoacoustic optimization)
-    return avgGainReduction * 0.75f;
+    updateHistory();
+
+    const int latency = engineLatency.load(std::memory_order_relaxed);
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
 }
 
-float MixCompressorAudioProcessor::applyDCBlocker(float sample, int channel)
+void MixCompressorAudioProcessor::updateHistory()
 {
-    float y = sample - dcBlockerX1[channel] + (dcBlockerA1 * dcBlockerY1[channel]);
-    dcBlockerX1[channel] = sample;
-    dcBlockerY1[channel] = y;
-    return y;
+    for (;;)
+    {
+        const int numRead = engine.readHistory(historyReadBins, historyReadChunk);
+
+        for (int i = 0; i < numRead; ++i)
+        {
+            const auto& src = historyReadBins[i];
+            HistoryBin bin;
+            bin.grMin = src.grMin;
+            bin.grMax = src.grMax;
+            bin.inputMin = bin.inputMax = src.inputPeakDB;
+            bin.outputMin = bin.outputMax = src.outputPeakDB;
+            levelHistory.push(bin);
+        }
+
+        if (numRead < historyReadChunk)
+            break;
+    }
 }
 
 void MixCompressorAudioProcessor::loadPreset(PresetMode preset)
@@ -489,111 +583,102 @@ void MixCompressorAudioProcessor::loadPreset(PresetMode preset)
 }
 
 //==============================================================================
-// CompressorStage Implementation with Topology Modeling
-void MixCompressorAudioProcessor::CompressorStage::prepare(double sr)
+namespace
 {
-    sampleRate = sr;
-    reset();
+    // Parameters a library preset sets, by APVTS ID and mixcomp_params field; bools and
+    // choices take their value (0/1, index) like the floats
+    struct PresetField
+    {
+        const char* parameterID;
+        float mixcomp_params::* floatField;
+        int mixcomp_params::* intField;
+    };
+
+    const PresetField presetFields[] =
+    {
+        { "topology",          nullptr,                                &mixcomp_params::topology },
+        { "scHPF",             &mixcomp_params::sc_hpf_hz,             nullptr },
+        { "scEQ",              nullptr,                                &mixcomp_params::sc_eq_shape },
+        { "scEQFreq",          &mixcomp_params::sc_eq_freq_hz,         nullptr },
+        { "scEQGain",          &mixcomp_params::sc_eq_gain_db,         nullptr },
+        { "threshold1",        &mixcomp_params::threshold1_db,         nullptr },
+        { "ratio1",            &mixcomp_params::ratio1,                nullptr },
+        { "attack1",           &mixcomp_params::attack1_ms,            nullptr },
+        { "release1",          &mixcomp_params::release1_ms,           nullptr },
+        { "dualStage",         nullptr,                                &mixcomp_params::dual_stage },
+        { "threshold2",        &mixcomp_params::threshold2_db,         nullptr },
+        { "ratio2",            &mixcomp_params::ratio2,                nullptr },
+        { "attack2",           &mixcomp_params::attack2_ms,            nullptr },
+        { "release2",          &mixcomp_params::release2_ms,           nullptr },
+        { "knee",              &mixcomp_params::knee_db,               nullptr },
+        { "makeup",            &mixcomp_params::makeup_db,             nullptr },
+        { "autoMakeup",        nullptr,                                &mixcomp_params::auto_makeup },
+        { "mix",               &mixcomp_params::mix_percent,           nullptr },
+        { "detectorRate",      nullptr,                                &mixcomp_params::detector_rate },
+        { "truePeak",          nullptr,                                &mixcomp_params::true_peak_detect },
+        { "doublePrecision",   nullptr,                                &mixcomp_params::double_precision },
+        { "upwardThreshold",   &mixcomp_params::upward_threshold_db,   nullptr },
+        { "upwardRatio",       &mixcomp_params::upward_ratio,          nullptr },
+        { "expanderThreshold", &mixcomp_params::expander_threshold_db, nullptr },
+        { "expanderRatio",     &mixcomp_params::expander_ratio,        nullptr },
+        { "expanderRange",     &mixcomp_params::expander_range_db,     nullptr },
+        { "outputLimiter",     nullptr,                                &mixcomp_params::output_limiter },
+        { "limiterCeiling",    &mixcomp_params::limiter_ceiling_db,    nullptr },
+        { "limiterRelease",    &mixcomp_params::limiter_release_ms,    nullptr },
+    };
 }
 
-void MixCompressorAudioProcessor::CompressorStage::setParameters(float threshold, float newRatio, float attack, float release, float knee)
+juce::File MixCompressorAudioProcessor::getPresetLibraryFile() const
 {
-    thresholdDB = threshold;
-    compRatio = juce::jmax(1.0f, newRatio);
-    kneeWidth = knee;
-
-    // Time constant conversion with safe bounds
-    float attackMs = juce::jmax(0.1f, attack);
-    float releaseMs = juce::jmax(20.0f, release);
+    const auto overridePath = juce::SystemStats::getEnvironmentVariable("MIXCOMP_PRESET_LIBRARY", {});
+    if (overridePath.isNotEmpty())
+        return juce::File(overridePath);
 
-    attackCoef = 1.0f - std::exp(-1.0f / (attackMs * 0.001f * static_cast<float>(sampleRate)));
-    releaseCoef = 1.0f - std::exp(-1.0f / (releaseMs * 0.001f * static_cast<float>(sampleRate)));
-
-    attackCoef = juce::jlimit(0.0001f, 0.9999f, attackCoef);
-    releaseCoef = juce::jlimit(0.0001f, 0.9999f, releaseCoef);
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("MixCompressor").getChildFile("Presets.mcpl");
 }
 
-float MixCompressorAudioProcessor::CompressorStage::processSample(float input, float& grOut, float sc_signal, TopologyMode mode)
+std::shared_ptr<const PresetLibrary> MixCompressorAudioProcessor::openPresetLibrary(juce::String& error)
 {
-    // Use sidechain signal for detection
-    float detectorSignal = std::fabs(sc_signal);
-
-    // Peak envelope follower
-    if (detectorSignal > peakEnvelope)
-        peakEnvelope += (detectorSignal - peakEnvelope) * attackCoef;
-    else
-        peakEnvelope += (detectorSignal - peakEnvelope) * releaseCoef;
-
-    peakEnvelope = juce::jlimit(0.0f, 10.0f, peakEnvelope);
-
-    // Convert to dB
-    float envDB = juce::Decibels::gainToDecibels(peakEnvelope + 1e-6f);
-
-    // Apply compression curve
-    float gainReductionDB = applyCompressionCurve(envDB);
-    grOut = gainReductionDB;
-
-    // Convert to linear gain
-    float targetGain = juce::Decibels::decibelsToGain(-gainReductionDB);
-
-    // Smooth gain changes
-    gainSmooth += (targetGain - gainSmooth) * gainSmoothingCoef;
-    gainSmooth = juce::jlimit(0.01f, 1.0f, gainSmooth);
-
-    // Apply gain and topology shaping
-    float output = input * gainSmooth;
-    return applyTopologyShaper(output, mode);
+    std::string openError;
+    presetLibrary = PresetLibrary::open(getPresetLibraryFile().getFullPathName().toStdString(), openError);
+    error = openError;
+    return presetLibrary;
 }
 
-float MixCompressorAudioProcessor::CompressorStage::applyCompressionCurve(float inputDB)
+void MixCompressorAudioProcessor::loadLibraryPreset(const PresetLibrary& library, int entry)
 {
-    float overThreshold = inputDB - thresholdDB;
-
-    if (overThreshold <= -kneeWidth * 0.5f)
-    {
-        return 0.0f;
-    }
-    else if (overThreshold >= kneeWidth * 0.5f)
-    {
-        float grDB = overThreshold * (1.0f - 1.0f / compRatio);
-        return juce::jlimit(0.0f, 60.0f, grDB);
-    }
-    else
-    {
-        // Soft knee
-        float kneeInput = overThreshold + kneeWidth * 0.5f;
-        float kneeFactor = (kneeInput * kneeInput) / (2.0f * kneeWidth);
-        float grDB = kneeFactor * (1.0f - 1.0f / compRatio);
-        return juce::jlimit(0.0f, 60.0f, grDB);
-    }
+    mixcomp_params params;
+    if (library.getParams(entry, params))
+        applyPresetParameters(params);
 }
 
-float MixCompressorAudioProcessor::CompressorStage::applyTopologyShaper(float input, TopologyMode mode)
+void MixCompressorAudioProcessor::applyPresetParameters(const mixcomp_params& params)
 {
-    // Topology-specific harmonic generation
-    switch (mode)
-    {
-    case TopologyMode::VCA:
-        // Clean, odd harmonics (0.01-0.1% THD)
-        return input + (input * input * input) * 0.0005f;
+    parameterBatch.fetch_add(1);
 
-    case TopologyMode::FET:
-        // 2nd + 3rd harmonics (0.1-0.5% THD)
-        return input + (input * input) * 0.002f + (input * input * input) * 0.003f;
+    for (const auto& field : presetFields)
+    {
+        auto* parameter = apvts.getParameter(field.parameterID);
+        if (parameter == nullptr)
+            continue;
 
-    case TopologyMode::Optical:
-        // Smooth, program-dependent (0.05-0.3% THD)
-        return input + std::tanh(input * 2.0f) * 0.001f;
+        const float value = field.floatField != nullptr ? params.*field.floatField : static_cast<float>(params.*field.intField);
+        const float normalised = parameter->convertTo0to1(value);
 
-    default:
-        return input;
+        if (parameter->getValue() != normalised)
+        {
+            parameter->beginChangeGesture();
+            parameter->setValueNotifyingHost(normalised);
+            parameter->endChangeGesture();
+        }
     }
-}
 
-void MixCompressorAudioProcessor::CompressorStage::reset()
-{
-    peakEnvelope = 0.0f;
-    gainSmooth = 1.0f;
+    // The factory preset selector no longer describes the settings
+    if (auto* preset = apvts.getParameter("preset"))
+        preset->setValueNotifyingHost(0.0f);
+
+    parameterBatch.fetch_add(1);
 }
 
 //==============================================================================
@@ -619,8 +704,13 @@ void MixCompressorAudioProcessor::setStateInformation(const void* data, int size
 {
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState.get() != nullptr)
+    {
         if (xmlState->hasTagName(apvts.state.getType()))
+        {
             apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+            engine.setLinkGroup(getLinkGroup().toRawUTF8());
+        }
+    }
 }
 
 //==============================================================================
@@ -2,9 +2,14 @@
 
 #include <JuceHeader.h>
 #include <atomic>
+#include "LevelHistory.h"
+#include "Core/CompressorEngine.h"
+#include "Core/PresetLibrary.h"
+#include "Core/ResourceWorker.h"
 
 //==============================================================================
-class MixCompressorAudioProcessor : public juce::AudioProcessor
+class MixCompressorAudioProcessor : public juce::AudioProcessor,
+    private juce::Timer
 {
 public:
     //==============================================================================
@@ -21,12 +26,13 @@ public:
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
+    // Host track name becomes the telemetry label
+    void updateTrackProperties(const TrackProperties& properties) override;
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
 
-    // NOTE: Removed override - not in base class
-    int getLatencySamples() const { return lookAheadSamples; }
     double getTailLengthSeconds() const override;
 
     //==============================================================================
@@ -67,78 +73,121 @@ public:
     };
 
     void loadPreset(PresetMode preset);
-    float getCurrentGainReduction() const { return currentGainReduction; }
-    float getInputRMS() const { return inputRMS; }
-    float getOutputRMS() const { return outputRMS; }
+
+    // On-disk preset library (message thread), mapped once per process and shared by every
+    // instance: MIXCOMP_PRESET_LIBRARY, else Presets.mcpl in the user's MixCompressor folder.
+    // nullptr with error set when there is none.
+    std::shared_ptr<const PresetLibrary> openPresetLibrary(juce::String& error);
+    juce::File getPresetLibraryFile() const;
+    void loadLibraryPreset(const PresetLibrary& library, int entry);
+
+    // Sets every parameter a preset defines (all but the link mode and the CPU settings) as
+    // one batch: the audio thread keeps its previous snapshot until the batch is complete
+    void applyPresetParameters(const mixcomp_params& params);
+    float getCurrentGainReduction() const { return engine.getGainReduction(); }
+    float getInputRMS() const { return engine.getInputRMS(); }
+    float getOutputRMS() const { return engine.getOutputRMS(); }
+
+    // Adaptive quality tier (QualityGovernor::Tier) and smoothed load as a fraction of the deadline
+    bool isAdaptiveQualityEnabled() const { return adaptiveQualityParam->load() > 0.5f; }
+    int getQualityTier() const { return engine.getQualityTier(); }
+    float getCPULoad() const { return engine.getCPULoad(); }
+
+    // True while the host bounces (isNonRealtime) and the offline profile is enabled; the
+    // engine then runs the offline quality settings instead of the realtime ones
+    bool isUsingOfflineProfile() const { return isNonRealtime() && offlineProfileParam->load() > 0.5f; }
+
+    // Scrolling history (message thread): drains bins captured by the audio thread into the mipmap
+    void updateHistory();
+    const LevelHistory& getLevelHistory() const { return levelHistory; }
+    double getHistoryBinSeconds() const { return engine.getHistoryBinSeconds(); }
 
     // Parameter access
     juce::AudioProcessorValueTreeState& getValueTreeState() { return apvts; }
 
-private:
-    //==============================================================================
-    // Compressor engine with psychoacoustic modeling
-    class CompressorStage
-    {
-    public:
-        void prepare(double sampleRate);
-        float processSample(float input, float& grOut, float sc_signal, TopologyMode mode);
-        void reset();
-        void setParameters(float threshold, float ratio, float attack, float release, float knee);
-
-    private:
-        // Peak detection with proper ballistics
-        float peakEnvelope = 0.0f;
-        float gainSmooth = 1.0f;
-
-        float attackCoef = 0.0f;
-        float releaseCoef = 0.0f;
-        float thresholdDB = -24.0f;
-        float compRatio = 4.0f;
-        float kneeWidth = 6.0f;
-        double sampleRate = 44100.0;
-
-        // Gain smoothing to prevent clicks
-        static constexpr float gainSmoothingCoef = 0.9999f;
-
-        float applyCompressionCurve(float inputDB);
-        float applyTopologyShaper(float input, TopologyMode mode);
-    };
+    // Detector link group shared with other instances in this process (message thread);
+    // stored in the plugin state, empty means not linked
+    void setLinkGroup(const juce::String& name);
+    juce::String getLinkGroup() const;
 
+    // DSP kernel variant: chosen from CPUID at prepareToPlay unless overridden (takes effect
+    // at the next prepareToPlay; the MIXCOMP_KERNELS environment variable also overrides)
+    void setKernelVariantOverride(DSPKernels::Variant variant) { engine.setKernelVariantOverride(variant); }
+    void clearKernelVariantOverride() { engine.clearKernelVariantOverride(); }
+    DSPKernels::Variant getKernelVariant() const { return engine.getKernelVariant(); }
+
+private:
     //==============================================================================
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // DSP Components
-    CompressorStage stage1; // Leveler
-    CompressorStage stage2; // Peak catcher
-
-    // Side-chain HPF (for detector signal) - Second-order Butterworth
-    juce::dsp::StateVariableTPTFilter<float> sideChainHPF[2];
-
-    // Look-ahead buffer for phase-coherent processing
-    static constexpr int maxLookAheadSamples = 96; // ~2ms @ 48kHz
-    juce::dsp::DelayLine<float> lookAheadBuffer{ (size_t)maxLookAheadSamples };
-    int lookAheadSamples = 0;
-
-    // Metering
-    std::atomic<float> currentGainReduction{ 0.0f };
-
-    // Auto makeup gain with psychoacoustic headroom
-    float calculateAutoMakeup(float avgGainReduction);
-    juce::SmoothedValue<float> makeupGainSmoothed;
-
-    // RMS calculation for level-matched comparison (±0.5 dB accuracy)
-    float inputRMS = 0.0f;
-    float outputRMS = 0.0f;
-    static constexpr float rmsAlpha = 0.99f;
-
-    // DC blocker to prevent offset issues
-    float dcBlockerX1[2] = { 0.0f };
-    float dcBlockerY1[2] = { 0.0f };
-    static constexpr float dcBlockerA1 = 0.9997f;
-
-    // Helper functions
-    float applyDCBlocker(float sample, int channel);
+    // Raw parameter values, looked up once instead of on every callback
+    std::atomic<float>* scHPFParam = nullptr;
+    std::atomic<float>* topologyParam = nullptr;
+    std::atomic<float>* threshold1Param = nullptr;
+    std::atomic<float>* ratio1Param = nullptr;
+    std::atomic<float>* attack1Param = nullptr;
+    std::atomic<float>* release1Param = nullptr;
+    std::atomic<float>* kneeParam = nullptr;
+    std::atomic<float>* upwardThresholdParam = nullptr;
+    std::atomic<float>* upwardRatioParam = nullptr;
+    std::atomic<float>* expanderThresholdParam = nullptr;
+    std::atomic<float>* expanderRatioParam = nullptr;
+    std::atomic<float>* expanderRangeParam = nullptr;
+    std::atomic<float>* dualStageParam = nullptr;
+    std::atomic<float>* threshold2Param = nullptr;
+    std::atomic<float>* ratio2Param = nullptr;
+    std::atomic<float>* attack2Param = nullptr;
+    std::atomic<float>* release2Param = nullptr;
+    std::atomic<float>* makeupParam = nullptr;
+    std::atomic<float>* autoMakeupParam = nullptr;
+    std::atomic<float>* mixParam = nullptr;
+    std::atomic<float>* detectorRateParam = nullptr;
+    std::atomic<float>* scEQParam = nullptr;
+    std::atomic<float>* scEQFreqParam = nullptr;
+    std::atomic<float>* scEQGainParam = nullptr;
+    std::atomic<float>* linkModeParam = nullptr;
+    std::atomic<float>* adaptiveQualityParam = nullptr;
+    std::atomic<float>* cpuBudgetParam = nullptr;
+    std::atomic<float>* outputLimiterParam = nullptr;
+    std::atomic<float>* limiterCeilingParam = nullptr;
+    std::atomic<float>* limiterReleaseParam = nullptr;
+    std::atomic<float>* truePeakParam = nullptr;
+    std::atomic<float>* doublePrecisionParam = nullptr;
+    std::atomic<float>* offlineProfileParam = nullptr;
+    std::atomic<float>* offlineDetectorRateParam = nullptr;
+    std::atomic<float>* offlineTruePeakParam = nullptr;
+    std::atomic<float>* offlineDoublePrecisionParam = nullptr;
+
+    static constexpr const char* linkGroupProperty = "linkGroup";
+
+    // Odd while applyPresetParameters writes; processBlock and the resource worker only
+    // snapshot between batches
+    std::atomic<std::uint32_t> parameterBatch{ 0 };
+    std::shared_ptr<const PresetLibrary> presetLibrary;
+
+    // Copies the raw parameter values into the engine's parameter struct
+    mixcomp_params getEngineParameters() const;
+
+    // Same, read under the parameterBatch seqlock; false while a preset is half applied
+    bool readEngineParameters(mixcomp_params& params) const;
+
+    // All DSP lives in the JUCE-free core (Core/), shared with the C API and the command-line tools
+    CompressorEngine engine;
+
+    // Builds the engine's resources (filter designs, tables) off the audio thread; declared
+    // after the engine so it stops before the engine goes away
+    ResourceWorker resourceWorker{ engine, [this](mixcomp_params& params) { return readEngineParameters(params); } };
+
+    // Housekeeping on the message thread, whether or not an editor is open: drains the
+    // history (the engine's FIFO holds about 20 s) and reports latency changes to the host
+    std::atomic<int> engineLatency{ 0 };    // as of the last processBlock
+    static constexpr int housekeepingIntervalMs = 250;
+    void timerCallback() override;
+
+    static constexpr int historyReadChunk = 256;
+    CompressorEngine::HistoryBin historyReadBins[historyReadChunk];
+    LevelHistory levelHistory;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixCompressorAudioProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "PresetBrowser.h"
+
+namespace
+{
+    juce::String toString(std::string_view text)
+    {
+        return juce::String::fromUTF8(text.data(), static_cast<int>(text.size()));
+    }
+}
+
+//==============================================================================
+PresetBrowser::PresetBrowser(MixCompressorAudioProcessor& p)
+    : processor(p)
+{
+    juce::String error;
+    library = processor.openPresetLibrary(error);
+
+    searchEditor.setTextToShowWhenEmpty("search names", juce::Colours::grey);
+    searchEditor.onTextChange = [this] { updateMatches(); };
+    searchEditor.onReturnKey = [this] { load(juce::jmax(0, list.getSelectedRow())); };
+    addAndMakeVisible(searchEditor);
+
+    tagFilter.addItem("Any tag", 1);
+    if (library != nullptr)
+        for (int tag = 0; tag < library->getNumTags(); ++tag)
+            tagFilter.addItem(toString(library->getTagName(tag)), tag + 2);
+    tagFilter.setSelectedId(1, juce::dontSendNotification);
+    tagFilter.onChange = [this] { updateMatches(); };
+    addAndMakeVisible(tagFilter);
+
+    topologyFilter.addItem("Any topology", 1);
+    topologyFilter.addItem("VCA", 2);
+    topologyFilter.addItem("FET", 3);
+    topologyFilter.addItem("Optical", 4);
+    topologyFilter.setSelectedId(1, juce::dontSendNotification);
+    topologyFilter.onChange = [this] { updateMatches(); };
+    addAndMakeVisible(topologyFilter);
+
+    list.setRowHeight(22);
+    list.setColour(juce::ListBox::backgroundColourId, juce::Colour(0xff1a1a1a));
+    addAndMakeVisible(list);
+
+    statusLabel.setFont(juce::FontOptions(10.0f));
+    statusLabel.setColour(juce::Label::textColourId, juce::Colours::white.withAlpha(0.7f));
+    addAndMakeVisible(statusLabel);
+
+    if (library == nullptr)
+        statusLabel.setText("No preset library (" + error + ")", juce::dontSendNotification);
+    else
+        updateMatches();
+
+    setSize(380, 440);
+}
+
+void PresetBrowser::resized()
+{
+    auto area = getLocalBounds().reduced(5);
+    searchEditor.setBounds(area.removeFromTop(26));
+    area.removeFromTop(5);
+
+    auto filters = area.removeFromTop(24);
+    tagFilter.setBounds(filters.removeFromLeft(filters.getWidth() / 2 - 3));
+    topologyFilter.setBounds(filters.removeFromRight(filters.getWidth() - 3));
+    area.removeFromTop(5);
+
+    statusLabel.setBounds(area.removeFromBottom(20));
+    list.setBounds(area);
+}
+
+//==============================================================================
+int PresetBrowser::getNumRows()
+{
+    if (library == nullptr)
+        return 0;
+
+    return filtered ? static_cast<int>(matches.size()) : library->getNumEntries();
+}
+
+int PresetBrowser::getEntry(int row) const
+{
+    if (library == nullptr || row < 0)
+        return -1;
+
+    if (filtered)
+        return row < static_cast<int>(matches.size()) ? matches[(size_t)row] : -1;
+
+    return row < library->getNumEntries() ? row : -1;
+}
+
+void PresetBrowser::paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool rowIsSelected)
+{
+    const int entry = getEntry(row);
+    if (entry < 0)
+        return;
+
+    if (rowIsSelected)
+        g.fillAll(juce::Colour(0xff4a9eff).withAlpha(0.4f));
+
+    // Only visible rows are drawn, so the tag list is built for a screenful at most
+    static const char* topologyNames[] = { "VCA", "FET", "OPT" };
+    const int topology = library->getTopology(entry);
+    juce::String details = topology >= 0 && topology < 3 ? topologyNames[topology] : "";
+
+    for (int tag = 0; tag < library->getNumTags(); ++tag)
+        if ((library->getTags(entry) >> tag & 1) != 0)
+            details << "  " << toString(library->getTagName(tag));
+
+    auto bounds = juce::Rectangle<int>(width, height).reduced(6, 0);
+
+    g.setColour(juce::Colours::white.withAlpha(0.5f));
+    g.setFont(juce::FontOptions(10.0f));
+    g.drawText(details, bounds.removeFromRight(width / 2), juce::Justification::centredRight, true);
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::FontOptions(13.0f));
+    g.drawText(toString(library->getName(entry)), bounds, juce::Justification::centredLeft, true);
+}
+
+void PresetBrowser::listBoxItemDoubleClicked(int row, const juce::MouseEvent&)
+{
+    load(row);
+}
+
+void PresetBrowser::returnKeyPressed(int lastRowSelected)
+{
+    load(lastRowSelected);
+}
+
+//==============================================================================
+void PresetBrowser::updateMatches()
+{
+    if (library == nullptr)
+        return;
+
+    const auto text = searchEditor.getText().trim().toStdString();
+
+    PresetLibrary::Query query;
+    query.nameContains = text;
+    query.requiredTags = tagFilter.getSelectedId() > 1 ? std::uint64_t(1) << (tagFilter.getSelectedId() - 2) : 0;
+    query.topology = topologyFilter.getSelectedId() - 2;
+
+    filtered = !text.empty() || query.requiredTags != 0 || query.topology >= 0;
+
+    if (filtered)
+        library->search(query, matches);
+    else
+        matches.clear();
+
+    list.deselectAllRows();
+    list.updateContent();
+    list.scrollToEnsureRowIsOnscreen(0);
+
+    statusLabel.setText(juce::String(getNumRows()) + " of " + juce::String(library->getNumEntries())
+        + " presets (double-click or return to load)", juce::dontSendNotification);
+}
+
+void PresetBrowser::load(int row)
+{
+    const int entry = getEntry(row);
+    if (entry < 0)
+        return;
+
+    processor.loadLibraryPreset(*library, entry);
+    statusLabel.setText("Loaded " + toString(library->getName(entry)), juce::dontSendNotification);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+// Browser for the on-disk preset library, shown in a call-out from the editor. Rows are
+// drawn straight from the mapped index, so opening and scrolling cost the same for any
+// library size; typing or changing a filter rescans the index without reading a preset.
+// Double-click or return loads the selected entry in one batched parameter update.
+class PresetBrowser : public juce::Component,
+    private juce::ListBoxModel
+{
+public:
+    explicit PresetBrowser(MixCompressorAudioProcessor& p);
+
+    void resized() override;
+
+private:
+    int getNumRows() override;
+    void paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    void listBoxItemDoubleClicked(int row, const juce::MouseEvent&) override;
+    void returnKeyPressed(int lastRowSelected) override;
+
+    void updateMatches();
+    int getEntry(int row) const;
+    void load(int row);
+
+    MixCompressorAudioProcessor& processor;
+    std::shared_ptr<const PresetLibrary> library;
+
+    juce::TextEditor searchEditor;
+    juce::ComboBox tagFilter, topologyFilter;
+    juce::ListBox list{ "Presets", this };
+    juce::Label statusLabel;
+
+    // Matching entries while a filter is set; unfiltered, rows are the entries themselves
+    bool filtered = false;
+    std::vector<int> matches;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBrowser)
+};
\ No newline at end of file